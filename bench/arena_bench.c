@@ -0,0 +1,478 @@
+// Exposes posix_memalign and clock_gettime when compiling with a strict -std=c11
+#define _DEFAULT_SOURCE
+
+#include "bench.h"
+#include "arena.h"
+#include "arena_concurrent.h"
+#include "arena_pool.h"
+#include "arena_slab.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static bool bench_json = false;
+static bool bench_quick = false;
+static bool bench_first_row = true;
+
+double bench_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+size_t bench_iterations(size_t iterations) {
+    if (!bench_quick) { return iterations; }
+    return iterations / 16 > 0 ? iterations / 16 : 1;
+}
+
+void bench_report(const char* benchmark, const char* variant, size_t size, size_t alignment,
+                  size_t operations, double seconds) {
+    double ns_per_op = seconds * 1e9 / (double)operations;
+    double ops_per_sec = (double)operations / seconds;
+
+    if (bench_json) {
+        printf("%s\n  {\"benchmark\": \"%s\", \"variant\": \"%s\", \"size\": %zu, \"alignment\": %zu, "
+               "\"operations\": %zu, \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f}",
+               bench_first_row ? "" : ",", benchmark, variant, size, alignment, operations, ns_per_op, ops_per_sec);
+    } else {
+        printf("%s,%s,%zu,%zu,%zu,%.3f,%.0f\n", benchmark, variant, size, alignment, operations, ns_per_op, ops_per_sec);
+    }
+    bench_first_row = false;
+    fflush(stdout);
+}
+
+// Pointers are stored here so the compiler cannot drop the allocations that produced them.
+static const void* volatile bench_sink;
+
+void bench_consume(const void* ptr) {
+    bench_sink = ptr;
+}
+
+// Number of allocations per round for the given size, so one round touches a bounded amount of memory.
+static size_t bench_batch(size_t size) {
+    size_t batch = ((size_t)64 << 20) / size;
+    if (batch > 4096) { batch = 4096; }
+    if (batch < 16) { batch = 16; }
+    return batch;
+}
+
+// Total number of allocations for the given size, so small sizes run long enough to measure.
+static size_t bench_operations(size_t size) {
+    size_t operations = ((size_t)1 << 30) / size;
+    if (operations > 2000000) { operations = 2000000; }
+    if (operations < 1000) { operations = 1000; }
+    return bench_iterations(operations);
+}
+
+// arena_allocate into an arena that already holds a whole round, reset after every round.
+static void bench_arena_allocate(size_t size, size_t alignment, unsigned int flags, const char* variant) {
+    size_t batch = bench_batch(size);
+    size_t rounds = bench_operations(size) / batch + 1;
+    Arena* arena = arena_new(batch * (size + alignment), false);
+    if (!arena) { return; }
+
+    // Fault the block in once so page faults are not part of the measurement. Going through the
+    // arena raises its known-zero watermark, so the zeroing variant zeroes from the first round on.
+    size_t block_size = arena->end - arena->start;
+    memset(arena_allocate_ex(arena, block_size, 1, ARENA_ALLOC_NO_ZERO), 1, block_size);
+    arena_reset(arena);
+
+    double start = bench_now();
+    for (size_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < batch; i++) {
+            bench_consume(arena_allocate_ex(arena, size, alignment, flags));
+        }
+        arena_reset(arena);
+    }
+    bench_report("allocate", variant, size, alignment, rounds * batch, bench_now() - start);
+    arena_free(arena);
+}
+
+// arena_allocate into a small fresh arena that has to grow during every round.
+static void bench_arena_allocate_growth(size_t size, size_t alignment) {
+    size_t batch = bench_batch(size);
+    size_t rounds = bench_operations(size) / batch + 1;
+
+    double start = bench_now();
+    for (size_t round = 0; round < rounds; round++) {
+        Arena* arena = arena_new(4096, true);
+        if (!arena) { return; }
+        for (size_t i = 0; i < batch; i++) {
+            bench_consume(arena_allocate(arena, size, alignment));
+        }
+        arena_free(arena);
+    }
+    bench_report("allocate", "arena_growth", size, alignment, rounds * batch, bench_now() - start);
+}
+
+// Fills a small fresh arena with 8 MiB of allocations under different growth policies.
+static void bench_growth_policy(size_t size, const ArenaGrowthPolicy* policy, const char* variant) {
+    size_t batch = ((size_t)8 << 20) / size;
+    size_t rounds = bench_iterations(128);
+
+    double start = bench_now();
+    for (size_t round = 0; round < rounds; round++) {
+        Arena* arena = arena_new(4096, false);
+        if (!arena) { return; }
+        arena_set_growth_policy(arena, policy);
+        for (size_t i = 0; i < batch; i++) {
+            bench_consume(arena_allocate_ex(arena, size, 8, ARENA_ALLOC_NO_ZERO));
+        }
+        arena_free(arena);
+    }
+    bench_report("growth_policy", variant, size, 8, rounds * batch, bench_now() - start);
+}
+
+static void bench_growth_policies(void) {
+    static const ArenaGrowthPolicy policies[] = {
+        { ARENA_GROWTH_GEOMETRIC, 2.0, 0, 0, 0, NULL, NULL },
+        { ARENA_GROWTH_GEOMETRIC, 1.5, 0, 0, 0, NULL, NULL },
+        { ARENA_GROWTH_GEOMETRIC, 2.0, 0, (size_t)1 << 20, 0, NULL, NULL },
+        { ARENA_GROWTH_LINEAR, 0.0, (size_t)64 << 10, 0, 0, NULL, NULL },
+        { ARENA_GROWTH_GEOMETRIC, 1.0, 0, 0, 0, NULL, NULL },
+    };
+    static const char* variants[] = { "geometric_2", "geometric_1.5", "geometric_2_max_1MiB", "linear_64KiB", "same_size" };
+    static const size_t sizes[] = { 64, 4096 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); p++) {
+            bench_growth_policy(sizes[s], &policies[p], variants[p]);
+        }
+    }
+}
+
+static void bench_malloc(size_t size, size_t alignment, bool aligned) {
+    size_t batch = bench_batch(size);
+    size_t rounds = bench_operations(size) / batch + 1;
+    void** ptrs = malloc(batch * sizeof(void*));
+    if (!ptrs) { return; }
+
+    double start = bench_now();
+    for (size_t round = 0; round < rounds; round++) {
+        for (size_t i = 0; i < batch; i++) {
+            if (aligned) {
+                if (posix_memalign(&ptrs[i], alignment, size) != 0) { ptrs[i] = NULL; }
+            } else {
+                ptrs[i] = malloc(size);
+            }
+            bench_consume(ptrs[i]);
+        }
+        for (size_t i = 0; i < batch; i++) { free(ptrs[i]); }
+    }
+    bench_report("allocate", aligned ? "posix_memalign_free" : "malloc_free", size, alignment, rounds * batch, bench_now() - start);
+    free(ptrs);
+}
+
+// Cost of arena_reset after a round of allocations, which is independent of how much was allocated.
+// A single reset is too short for the clock, so a batch of arenas is filled and then reset in one go.
+static void bench_reset(void) {
+    enum { BATCH = 64 };
+    size_t rounds = bench_iterations(200000) / BATCH;
+    if (rounds == 0) { rounds = 1; }
+
+    Arena* arenas[BATCH];
+    for (size_t a = 0; a < BATCH; a++) {
+        arenas[a] = arena_new(4096, true);
+        if (!arenas[a]) {
+            while (a > 0) { arena_free(arenas[--a]); }
+            return;
+        }
+    }
+
+    double total = 0.0;
+    for (size_t round = 0; round < rounds; round++) {
+        for (size_t a = 0; a < BATCH; a++) {
+            for (size_t i = 0; i < 64; i++) { bench_consume(arena_allocate(arenas[a], 256, 16)); }
+        }
+        double start = bench_now();
+        for (size_t a = 0; a < BATCH; a++) { arena_reset(arenas[a]); }
+        total += bench_now() - start;
+    }
+    bench_report("reset", "arena", 0, 0, rounds * BATCH, total);
+    for (size_t a = 0; a < BATCH; a++) { arena_free(arenas[a]); }
+}
+
+// Zeroing versus ARENA_ALLOC_NO_ZERO for multi-MB scratch buffers.
+static void bench_zeroing(void) {
+    static const size_t sizes[] = { (size_t)1 << 20, (size_t)4 << 20, (size_t)16 << 20, (size_t)64 << 20 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t size = sizes[s];
+        size_t rounds = bench_iterations(((size_t)4 << 30) / size);
+        Arena* arena = arena_new(size + ARENA_PAGE_SIZE, false);
+        if (!arena) { return; }
+
+        // Touch the block once so page faults are not part of the measurement. Going through the
+        // arena also raises its known-zero watermark, so the zeroed variant really zeroes.
+        memset(arena_allocate_ex(arena, size, ARENA_PAGE_SIZE, ARENA_ALLOC_NO_ZERO), 1, size);
+        arena_reset(arena);
+
+        double start = bench_now();
+        for (size_t round = 0; round < rounds; round++) {
+            bench_consume(arena_allocate_ex(arena, size, ARENA_PAGE_SIZE, ARENA_ALLOC_DEFAULT));
+            arena_reset(arena);
+        }
+        bench_report("large_allocate", "zeroed", size, ARENA_PAGE_SIZE, rounds, bench_now() - start);
+
+        start = bench_now();
+        for (size_t round = 0; round < rounds; round++) {
+            bench_consume(arena_allocate_ex(arena, size, ARENA_PAGE_SIZE, ARENA_ALLOC_NO_ZERO));
+            arena_reset(arena);
+        }
+        bench_report("large_allocate", "no_zero", size, ARENA_PAGE_SIZE, rounds, bench_now() - start);
+        arena_free(arena);
+    }
+}
+
+// Zeroed 64 KiB allocations filling a fresh arena and written once per page. The arena knows its
+// fresh memory is zero and skips the memset, the baseline zeroes every allocation explicitly.
+static void bench_first_fill(void) {
+    size_t total = (size_t)64 << 20;
+    size_t size = (size_t)64 << 10;
+    size_t rounds = bench_iterations(32);
+
+    for (int explicit_memset = 0; explicit_memset <= 1; explicit_memset++) {
+        double seconds = 0.0;
+        for (size_t round = 0; round < rounds; round++) {
+            Arena* arena = arena_new(total, false);
+            if (!arena) { return; }
+
+            double start = bench_now();
+            for (size_t offset = 0; offset < total; offset += size) {
+                char* ptr = arena_allocate_ex(arena, size, 64, explicit_memset ? ARENA_ALLOC_NO_ZERO : ARENA_ALLOC_DEFAULT);
+                if (explicit_memset) { memset(ptr, 0, size); }
+                for (size_t page = 0; page < size; page += ARENA_PAGE_SIZE) { ptr[page] = 1; }
+            }
+            seconds += bench_now() - start;
+            arena_free(arena);
+        }
+        bench_report("first_fill", explicit_memset ? "memset" : "known_zero", size, 64, rounds * (total / size), seconds);
+    }
+}
+
+// Frames of zeroed allocations with a reset in between, per zero mode. The time includes the resets,
+// so bulk zeroing at reset is compared against the memsets it saves.
+static void bench_zero_mode(void) {
+    static const char* const names[] = { "on_allocate", "on_reset", "on_reset_background" };
+    size_t total = (size_t)16 << 20;
+    size_t size = (size_t)4 << 10;
+    size_t frames = bench_iterations(64);
+
+    for (int mode = ARENA_ZERO_ON_ALLOCATE; mode <= ARENA_ZERO_ON_RESET_BACKGROUND; mode++) {
+        Arena* arena = arena_new(total, false);
+        if (!arena) { return; }
+        if (arena_set_zero_mode(arena, (ArenaZeroMode)mode) != ARENA_SUCCESS) {
+            arena_free(arena);
+            continue;
+        }
+
+        double start = bench_now();
+        for (size_t frame = 0; frame < frames; frame++) {
+            for (size_t offset = 0; offset < total; offset += size) {
+                char* ptr = arena_allocate(arena, size, 64);
+                ptr[0] = 1;
+                bench_consume(ptr);
+            }
+            arena_reset(arena);
+        }
+        bench_report("zero_mode", names[mode], size, 64, frames * (total / size), bench_now() - start);
+        arena_free(arena);
+    }
+}
+
+// Individually freed fixed-size objects: ArenaPool against malloc/free with the same churn pattern.
+static void bench_pool(size_t size) {
+    enum { LIVE = 1024 };
+    void* live[LIVE] = { 0 };
+    size_t operations = bench_iterations(4000000);
+
+    Arena* arena = arena_new((size_t)1 << 20, true);
+    if (!arena) { return; }
+    ArenaPool pool;
+    arena_pool_init(&pool, arena, size, 16);
+
+    double start = bench_now();
+    for (size_t i = 0; i < operations; i++) {
+        size_t index = (i * 7919) % LIVE;
+        arena_pool_free(&pool, live[index]);
+        live[index] = arena_pool_alloc(&pool);
+        bench_consume(live[index]);
+    }
+    bench_report("pool_churn", "arena_pool", size, 16, operations, bench_now() - start);
+    arena_free(arena);
+
+    memset(live, 0, sizeof(live));
+    start = bench_now();
+    for (size_t i = 0; i < operations; i++) {
+        size_t index = (i * 7919) % LIVE;
+        free(live[index]);
+        live[index] = malloc(size);
+        bench_consume(live[index]);
+    }
+    bench_report("pool_churn", "malloc_free", size, 16, operations, bench_now() - start);
+    for (size_t i = 0; i < LIVE; i++) { free(live[i]); }
+}
+
+// Individually freed objects of mixed sizes: ArenaSlab against malloc/free with the same churn pattern.
+static void bench_slab(void) {
+    enum { LIVE = 1024 };
+    void* live[LIVE] = { 0 };
+    size_t sizes[LIVE] = { 0 };
+    size_t operations = bench_iterations(4000000);
+
+    Arena* arena = arena_new((size_t)1 << 20, true);
+    if (!arena) { return; }
+    ArenaSlab slab;
+    arena_slab_init(&slab, arena);
+
+    double start = bench_now();
+    for (size_t i = 0; i < operations; i++) {
+        size_t index = (i * 7919) % LIVE;
+        arena_slab_free(&slab, live[index], sizes[index]);
+        sizes[index] = 16 + (i * 2654435761u) % 1024;
+        live[index] = arena_slab_alloc(&slab, sizes[index]);
+        bench_consume(live[index]);
+    }
+    bench_report("slab_churn", "arena_slab", 0, ARENA_SLAB_ALIGNMENT, operations, bench_now() - start);
+    arena_free(arena);
+
+    memset(live, 0, sizeof(live));
+    start = bench_now();
+    for (size_t i = 0; i < operations; i++) {
+        size_t index = (i * 7919) % LIVE;
+        free(live[index]);
+        live[index] = malloc(16 + (i * 2654435761u) % 1024);
+        bench_consume(live[index]);
+    }
+    bench_report("slab_churn", "malloc_free", 0, ARENA_SLAB_ALIGNMENT, operations, bench_now() - start);
+    for (size_t i = 0; i < LIVE; i++) { free(live[i]); }
+}
+
+typedef struct BenchThreadArgs {
+    ConcurrentArena* concurrent;
+    Arena* arena;
+    pthread_mutex_t* mutex;
+    size_t operations;
+} BenchThreadArgs;
+
+static void* bench_concurrent_worker(void* data) {
+    BenchThreadArgs* args = data;
+    for (size_t i = 0; i < args->operations; i++) {
+        bench_consume(concurrent_arena_allocate(args->concurrent, 32, 8));
+    }
+    return NULL;
+}
+
+static void* bench_mutex_worker(void* data) {
+    BenchThreadArgs* args = data;
+    for (size_t i = 0; i < args->operations; i++) {
+        pthread_mutex_lock(args->mutex);
+        bench_consume(arena_allocate(args->arena, 32, 8));
+        pthread_mutex_unlock(args->mutex);
+    }
+    return NULL;
+}
+
+static void bench_run_threads(size_t threads, void* (*worker)(void*), BenchThreadArgs* args, const char* variant) {
+    pthread_t ids[256];
+    size_t started = 0;
+    double start = bench_now();
+    while (started < threads && pthread_create(&ids[started], NULL, worker, args) == 0) { started++; }
+    for (size_t t = 0; t < started; t++) { pthread_join(ids[t], NULL); }
+    double seconds = bench_now() - start;
+
+    // A run with fewer threads than requested would be reported under the wrong thread count
+    if (started < threads) {
+        fprintf(stderr, "%s: could only start %zu of %zu threads, skipped\n", variant, started, threads);
+        return;
+    }
+    bench_report("concurrent_allocate", variant, 32, 8, threads * args->operations, seconds);
+}
+
+// Scalability of ConcurrentArena against a mutex protected Arena from 1 to `max_threads` threads.
+static void bench_concurrent(size_t max_threads) {
+    // Powers of two below `max_threads`, then `max_threads` itself even if it is not a power of two
+    size_t counts[16];
+    size_t count = 0;
+    for (size_t threads = 1; threads < max_threads; threads *= 2) { counts[count++] = threads; }
+    counts[count++] = max_threads;
+
+    for (size_t c = 0; c < count; c++) {
+        size_t threads = counts[c];
+        char variant[64];
+        BenchThreadArgs args = { NULL, NULL, NULL, bench_iterations(1000000) };
+
+        args.concurrent = concurrent_arena_new((size_t)1 << 20, true);
+        if (!args.concurrent) { return; }
+        snprintf(variant, sizeof(variant), "concurrent_arena_%zu_threads", threads);
+        bench_run_threads(threads, bench_concurrent_worker, &args, variant);
+        concurrent_arena_free(args.concurrent);
+
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        args.arena = arena_new((size_t)1 << 20, true);
+        args.mutex = &mutex;
+        if (!args.arena) { return; }
+        snprintf(variant, sizeof(variant), "mutex_arena_%zu_threads", threads);
+        bench_run_threads(threads, bench_mutex_worker, &args, variant);
+        arena_free(args.arena);
+    }
+}
+
+static void bench_usage(const char* program) {
+    fprintf(stderr, "usage: %s [--json] [--quick] [--threads N]\n", program);
+    fprintf(stderr, "  --json       print results as a JSON array instead of CSV\n");
+    fprintf(stderr, "  --quick      run 16x fewer iterations, for smoke testing\n");
+    fprintf(stderr, "  --threads N  largest thread count of the concurrent benchmark (default: number of CPUs)\n");
+}
+
+int main(int argc, char** argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_threads = cpus > 1 ? (size_t)cpus : 2;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            bench_json = true;
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            bench_quick = true;
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            max_threads = strtoul(argv[++i], NULL, 10);
+            if (max_threads < 1) { max_threads = 1; }
+            if (max_threads > 256) { max_threads = 256; }
+        } else {
+            bench_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (bench_json) {
+        printf("[");
+    } else {
+        printf("benchmark,variant,size,alignment,operations,ns_per_op,ops_per_sec\n");
+    }
+
+    static const size_t sizes[] = { 8, 64, 512, 4096, 65536, (size_t)1 << 20 };
+    static const size_t alignments[] = { 8, 64 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (size_t a = 0; a < sizeof(alignments) / sizeof(alignments[0]); a++) {
+            bench_arena_allocate(sizes[s], alignments[a], ARENA_ALLOC_DEFAULT, "arena");
+            bench_arena_allocate(sizes[s], alignments[a], ARENA_ALLOC_NO_ZERO, "arena_no_zero");
+            bench_arena_allocate_growth(sizes[s], alignments[a]);
+            bench_malloc(sizes[s], alignments[a], false);
+            bench_malloc(sizes[s], alignments[a], true);
+        }
+    }
+    bench_growth_policies();
+    bench_reset();
+    bench_zeroing();
+    bench_first_fill();
+    bench_zero_mode();
+    bench_pool(64);
+    bench_slab();
+    bench_concurrent(max_threads);
+    bench_containers();
+
+    if (bench_json) { printf("\n]\n"); }
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "bench.h"
+#include "arena.hpp"
+#include "arena_pmr.hpp"
+
+#include <functional>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Fills a vector, a string and an unordered_map the way a request handler would.
+void fill_pmr_containers(std::pmr::memory_resource* resource, std::size_t count) {
+    std::pmr::vector<int> values(resource);
+    std::pmr::string text(resource);
+    std::pmr::unordered_map<int, int> lookup(resource);
+    for (std::size_t i = 0; i < count; ++i) {
+        values.push_back(static_cast<int>(i));
+        text += 'x';
+        lookup[static_cast<int>(i)] = static_cast<int>(i);
+    }
+    bench_consume(values.data());
+    bench_consume(text.data());
+    bench_consume(&lookup);
+}
+
+void bench_pmr(std::size_t count) {
+    std::size_t rounds = bench_iterations(2000);
+
+    {
+        arena::Arena backing(1 << 20);
+        arena::MemoryResource resource(backing);
+        double start = bench_now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            fill_pmr_containers(&resource, count);
+            backing.reset();
+        }
+        bench_report("pmr_containers", "arena_memory_resource", count, 0, rounds * count, bench_now() - start);
+    }
+
+    {
+        std::vector<char> buffer(1 << 20);
+        double start = bench_now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            std::pmr::monotonic_buffer_resource resource(buffer.data(), buffer.size());
+            fill_pmr_containers(&resource, count);
+        }
+        bench_report("pmr_containers", "monotonic_buffer_resource", count, 0, rounds * count, bench_now() - start);
+    }
+
+    {
+        double start = bench_now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            fill_pmr_containers(std::pmr::new_delete_resource(), count);
+        }
+        bench_report("pmr_containers", "new_delete_resource", count, 0, rounds * count, bench_now() - start);
+    }
+}
+
+// Builds and walks a std::map, node locality shows up in the walk.
+template <typename Map>
+void fill_and_walk_map(Map& map, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) { map[static_cast<int>((i * 7919) % count)] = static_cast<float>(i); }
+    float sum = 0.0f;
+    for (const auto& entry : map) { sum += entry.second; }
+    bench_consume(&sum);
+}
+
+void bench_allocator(std::size_t count) {
+    std::size_t rounds = bench_iterations(500);
+
+    {
+        arena::Arena backing(1 << 20);
+        double start = bench_now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            {
+                std::map<int, float, std::less<int>, arena::Allocator<std::pair<const int, float>>> map(backing);
+                fill_and_walk_map(map, count);
+            }
+            backing.reset();
+        }
+        bench_report("map_insert_walk", "arena_allocator", count, 0, rounds * count, bench_now() - start);
+    }
+
+    {
+        double start = bench_now();
+        for (std::size_t round = 0; round < rounds; ++round) {
+            std::map<int, float> map;
+            fill_and_walk_map(map, count);
+        }
+        bench_report("map_insert_walk", "std_allocator", count, 0, rounds * count, bench_now() - start);
+    }
+}
+
+} // namespace
+
+extern "C" void bench_containers(void) {
+    bench_pmr(1000);
+    bench_allocator(10000);
+}
@@ -0,0 +1,31 @@
+#ifndef ARENA_BENCH_H
+#define ARENA_BENCH_H
+
+#include <stddef.h>  // for size_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Current time of a monotonic clock in seconds.
+double bench_now(void);
+
+// Scales an iteration count down when the suite runs with --quick.
+size_t bench_iterations(size_t iterations);
+
+// Prints one result row as CSV or JSON, depending on the command line.
+// `size` and `alignment` are 0 when they do not apply to the benchmark.
+void bench_report(const char* benchmark, const char* variant, size_t size, size_t alignment,
+                  size_t operations, double seconds);
+
+// Keeps the optimizer from removing work whose result is otherwise unused.
+void bench_consume(const void* ptr);
+
+// Container benchmarks for the C++ adapters (arena_pmr.hpp and arena.hpp).
+void bench_containers(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_BENCH_H
@@ -3,6 +3,40 @@
 
 #include <stddef.h>  // for size_t
 #include <stdbool.h> // for bool
+#include <stdint.h>  // for uintptr_t
+#include <string.h>  // for memset in the inline allocation fast path
+
+// Statistics counters are maintained by default, build with ARENA_STATS=0 to compile them out.
+// The fast path is inlined into callers, so the library and its users must agree on the value.
+#ifndef ARENA_STATS
+#define ARENA_STATS 1
+#endif
+
+// Per-tag accounting of `arena_allocate_tagged()` is off by default, build with ARENA_TAGS=1 to compile it in.
+#ifndef ARENA_TAGS
+#define ARENA_TAGS 0
+#endif
+
+// Compiler hints for the inline allocation fast path
+#if defined(__GNUC__) || defined(__clang__)
+#define ARENA_LIKELY(x)              __builtin_expect(!!(x), 1)
+#define ARENA_UNLIKELY(x)            __builtin_expect(!!(x), 0)
+#define ARENA_ATTR_MALLOC            __attribute__((malloc))
+#define ARENA_ATTR_ALLOC_SIZE(index) __attribute__((alloc_size(index)))
+#define ARENA_ATTR_ALLOC_ALIGN(index) __attribute__((alloc_align(index)))
+#define ARENA_ATTR_COLD              __attribute__((cold, noinline))
+#else
+#define ARENA_LIKELY(x)              (x)
+#define ARENA_UNLIKELY(x)            (x)
+#define ARENA_ATTR_MALLOC
+#define ARENA_ATTR_ALLOC_SIZE(index)
+#define ARENA_ATTR_ALLOC_ALIGN(index)
+#define ARENA_ATTR_COLD
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 /**
  * ArenaError: Represents the possible error states that can occur during operations within the Arena memory allocator.
  */
@@ -12,32 +46,253 @@ typedef enum {
     ARENA_ERROR_REALLOCATION_FAILED  /** Memory reallocation (for arena growth) failed. */
 } ArenaError;
 
+/**
+ * ArenaBacking: Describes where the memory of an arena comes from.
+ */
+typedef enum {
+    ARENA_BACKING_MALLOC,      /** Blocks are allocated with malloc and chained as the arena grows. */
+    ARENA_BACKING_VIRTUAL,     /** One reserved virtual address range whose pages are committed on demand. */
+    ARENA_BACKING_HUGETLB,     /** Blocks are mapped with explicit huge pages (MAP_HUGETLB). */
+    ARENA_BACKING_TRANSPARENT, /** Blocks are 2 MiB aligned mappings advised to use transparent huge pages. */
+    ARENA_BACKING_MMAP         /** Plain anonymous mappings: large blocks of a malloc arena, or the huge page fallback. */
+} ArenaBacking;
+
+/**
+ * ArenaAllocFlags: Flags that change how `arena_allocate_ex()` serves an allocation. They can be combined with `|`.
+ */
+typedef enum {
+    ARENA_ALLOC_DEFAULT          = 0,      /** Zero the memory and grow the arena if needed, like `arena_allocate()`. */
+    ARENA_ALLOC_NO_ZERO          = 1 << 0, /** Do not zero the memory, its content is unspecified. */
+    ARENA_ALLOC_NO_GROW          = 1 << 1, /** Return `NULL` instead of growing the arena when it is out of space. */
+    ARENA_ALLOC_ALIGN_CACHE_LINE = 1 << 2, /** Align the memory to at least `ARENA_CACHE_LINE_SIZE` bytes. */
+    ARENA_ALLOC_ALIGN_PAGE       = 1 << 3  /** Align the memory to at least `ARENA_PAGE_SIZE` bytes. */
+} ArenaAllocFlags;
+
+#define ARENA_CACHE_LINE_SIZE 64    // Alignment used by ARENA_ALLOC_ALIGN_CACHE_LINE
+#define ARENA_PAGE_SIZE       4096  // Alignment used by ARENA_ALLOC_ALIGN_PAGE
+
+/**
+ * @brief A single contiguous memory block owned by an arena.
+ *
+ * An arena is made of one or more blocks linked together. When the current block runs out of
+ * space a new block is chained after it instead of reallocating, so memory that was already
+ * handed out never moves and growing costs O(1) regardless of how much is in use.
+ *
+ * @param prev    The block that precedes this one in the chain (`NULL` for the first block).
+ * @param next    The block that follows this one. After a reset these blocks are recycled.
+ * @param start   A pointer to the first usable byte of the block.
+ * @param end     A pointer one past the last usable byte of the block.
+ * @param zero    The known-zero watermark: memory from here up to `end` has not been handed out since
+ *                the block was mapped (or trimmed), so it is still zero and needs no `memset`, except
+ *                for the discarded range.
+ * @param discarded     Start of a range a lazy `arena_reset_trim()` handed back while it was dirty, `NULL`
+ *                      if there is none. Its pages may still hold their contents, so the arena stops at
+ *                      `discarded` and raises its watermark to `discarded_end` before allocating past it.
+ * @param discarded_end End of the discarded range.
+ * @param backing The backing that was actually obtained for this block, which can differ from
+ *                the one the arena asked for when huge pages are unavailable.
+ */
+typedef struct ArenaBlock {
+    struct ArenaBlock* prev;    // Previous block in the chain
+    struct ArenaBlock* next;    // Next block in the chain (spare blocks after a reset)
+    char* start;                // First usable byte of the block
+    char* end;                  // One past the last usable byte of the block
+    char* zero;                 // Memory from here to end is known to be zero, saved when the arena leaves the block
+    char* discarded;            // Lazily trimmed range that may still be dirty, NULL if none
+    char* discarded_end;        // End of that range
+    ArenaBacking backing;       // Backing obtained for this block
+} ArenaBlock;
+
+/**
+ * @brief A snapshot of an arena's statistics, filled by `arena_get_stats()`.
+ *
+ * Counters accumulate over the whole lifetime of the arena and are not cleared by `arena_reset()`.
+ * They cost a few additions per allocation; when built with `ARENA_STATS=0` they are compiled out
+ * and stay zero, except for the sizes that are derived from the arena itself.
+ *
+ * @param allocations      The number of allocations served.
+ * @param bytes_requested  The sum of the requested sizes.
+ * @param bytes_consumed   The bytes the allocation position advanced by: requested plus padding.
+ * @param bytes_padding    The bytes skipped to align allocations.
+ * @param bytes_in_use     The bytes currently allocated, as returned by `arena_used()`.
+ * @param high_water       The largest `bytes_in_use` seen so far, across resets.
+ * @param capacity         The total size of all blocks, the committed size for virtual arenas.
+ * @param growths          The number of times the arena had to allocate a block or commit pages.
+ * @param bytes_copied     The bytes copied by `arena_realloc()` moving allocations. Growing the arena
+ *                         itself never copies, blocks are chained instead.
+ * @param grow_nanoseconds The total time spent growing the arena.
+ * @param pop_misses       The number of `arena_pop()` calls that were not on the top-most allocation.
+ * @param bytes_trimmed    The bytes returned to the system by `arena_reset_trim()`.
+ * @param large_objects    The number of live large objects, see `arena_set_large_threshold()`.
+ * @param large_bytes      The bytes requested by the live large objects. They are not part of `bytes_in_use` or `capacity`.
+ */
+typedef struct ArenaStats {
+    size_t allocations;         // Allocations served
+    size_t bytes_requested;     // Sum of the requested sizes
+    size_t bytes_consumed;      // Requested plus padding
+    size_t bytes_padding;       // Bytes skipped for alignment
+    size_t bytes_in_use;        // Bytes currently allocated
+    size_t high_water;          // Largest bytes_in_use seen, across resets
+    size_t capacity;            // Total size of all blocks
+    size_t growths;             // Blocks allocated or pages committed to make room
+    size_t bytes_copied;        // Bytes copied by arena_realloc
+    uint64_t grow_nanoseconds;  // Time spent growing
+    size_t pop_misses;          // arena_pop calls that were not on top
+    size_t bytes_trimmed;       // Bytes returned to the system by arena_reset_trim
+    size_t large_objects;       // Live large objects
+    size_t large_bytes;         // Bytes of the live large objects
+} ArenaStats;
+
+/**
+ * @brief The statistics counters an arena maintains, the source of `arena_get_stats()`.
+ *
+ * Only counters that are actually updated live here; the derived fields of `ArenaStats` are computed
+ * when the snapshot is taken. The three counters every allocation updates come first, so together with
+ * the allocation position they stay in the first cache line of `Arena`.
+ */
+typedef struct ArenaCounters {
+    size_t allocations;         // Allocations served
+    size_t bytes_requested;     // Sum of the requested sizes
+    size_t bytes_padding;       // Bytes skipped for alignment
+    size_t high_water;          // Largest usage recorded when memory was released
+    size_t growths;             // Blocks allocated or pages committed to make room
+    size_t bytes_copied;        // Bytes copied by arena_realloc
+    uint64_t grow_nanoseconds;  // Time spent growing
+    size_t pop_misses;          // arena_pop calls that were not on top
+    size_t bytes_trimmed;       // Bytes returned to the system by arena_reset_trim
+} ArenaCounters;
+
+/**
+ * ArenaGrowthKind: How `ArenaGrowthPolicy` sizes the next block of a growing arena.
+ */
+typedef enum {
+    ARENA_GROWTH_GEOMETRIC, /** The next block is `factor` times the previous one, amortized O(1) growth for any workload. */
+    ARENA_GROWTH_LINEAR,    /** The next block is `step` bytes larger than the previous one. */
+    ARENA_GROWTH_CALLBACK   /** The next block size is returned by `callback`. */
+} ArenaGrowthKind;
+
+// Returns the size of the next block, or 0 to refuse growing. `needed` is the smallest block that fits the request.
+typedef size_t (*ArenaGrowthCallback)(void* user_data, size_t previous_block_size, size_t needed, size_t arena_size);
+
+/**
+ * @brief Decides how large the blocks of a growing arena are, set with `arena_set_growth_policy()`.
+ *
+ * Whatever the policy computes, the new block is at least large enough for the request that
+ * triggered the growth, so a single large allocation never fails because of the policy alone.
+ *
+ * @param kind           How the next block size is computed.
+ * @param factor         `ARENA_GROWTH_GEOMETRIC`: multiplier applied to the previous block size (at least 1.0).
+ * @param step           `ARENA_GROWTH_LINEAR`: bytes added to the previous block size.
+ * @param max_block_size Upper bound on the computed block size, 0 for none. Bounds the memory a nearly
+ *                       empty last block can waste. Requests larger than it still get a block that fits.
+ * @param max_size       Hard cap on the total size of the arena, 0 for none. Growth beyond it fails
+ *                       and the allocation returns `NULL`.
+ * @param callback       `ARENA_GROWTH_CALLBACK`: computes the next block size.
+ * @param user_data      Passed to `callback`.
+ */
+typedef struct ArenaGrowthPolicy {
+    ArenaGrowthKind kind;          // How the next block size is computed
+    double factor;                 // Geometric multiplier
+    size_t step;                   // Linear increment in bytes
+    size_t max_block_size;         // Upper bound on a computed block size, 0 for none
+    size_t max_size;               // Hard cap on the arena size, 0 for none
+    ArenaGrowthCallback callback;  // Custom policy
+    void* user_data;               // Passed to callback
+} ArenaGrowthPolicy;
+
+/**
+ * @brief The allocations an arena served for one tag, see `arena_allocate_tagged()`.
+ *
+ * @param tag         The tag, a subsystem name or a call site from `ARENA_TAG_HERE`.
+ * @param allocations The number of allocations made with the tag since the arena was created.
+ * @param bytes       The bytes requested by those allocations.
+ */
+typedef struct ArenaTagStats {
+    const char* tag;     // Subsystem name or call site
+    size_t allocations;  // Allocations made with the tag
+    size_t bytes;        // Bytes requested by them
+} ArenaTagStats;
+
+/**
+ * @brief When the memory released by `arena_reset()` is zeroed again, see `arena_set_zero_mode()`.
+ */
+typedef enum {
+    ARENA_ZERO_ON_ALLOCATE,         /** Every zeroed allocation clears its own dirty memory (the default). */
+    ARENA_ZERO_ON_RESET,            /** `arena_reset()` clears all dirty memory in bulk. */
+    ARENA_ZERO_ON_RESET_BACKGROUND  /** A background thread clears it, the next allocation waits for it. */
+} ArenaZeroMode;
+
 /**
  * @brief Represents a linear memory arena.
  *
- * The `Arena` structure is a simple linear allocator that manages a contiguous block of memory.
- * It provides functions to allocate, reset, and free memory within this block.  Arenas are useful
+ * The `Arena` structure is a simple linear allocator that manages a chain of memory blocks.
+ * It provides functions to allocate, reset, and free memory within these blocks.  Arenas are useful
  * for scenarios where you want to avoid the overhead of frequent heap allocations and deallocations,
  * or when you want to manage memory for a specific purpose in a more controlled way. Usually its a far
  * better approach then to use malloc and free for every object you create. Think about the collective 
  * lifetime of objects and allocate objects with the same or similar life time in an arena.
  *
- * @param start   A pointer to the beginning of the arena's memory block.
- * @param current A pointer to the current allocation position within the memory block.
- * @param size    The total size (in bytes) of the arena's memory block.
- * @param if_size_too_small_double_in_size   Flag if set to true then the arena if it tries to automatically grow will double in size
+ * @param start   A pointer to the beginning of the current block's memory.
+ * @param current A pointer to the current allocation position within the current block.
+ * @param end     A pointer one past the end of the current block's memory.
+ * @param zero    The known-zero watermark of the current block. Memory at or above both `zero` and
+ *                `current` is still zero; `zero` catches up with `current` whenever `current` moves back.
+ * @param large_threshold Allocations larger than this bypass the blocks, `SIZE_MAX` when disabled.
+ * @param counters The statistics counters, read them with `arena_get_stats()`.
+ * @param size    The total size (in bytes) of all blocks owned by the arena.
+ * @param first   The first block of the chain.
+ * @param block   The block allocations are currently served from.
+ * @param backing Where the memory of the arena should come from, see `ArenaBacking`.
+ * @param reserved           For virtual arenas the size of the reserved address range, unused otherwise.
+ * @param commit_granularity For virtual arenas the number of bytes committed at once when `current` crosses `end`.
+ * @param generation         Incremented by every `arena_reset()`, lets structures layered on the arena (such as
+ *                           `ArenaPool`) notice that the memory they carved out has been released.
+ * @param used_before_block  The bytes allocated in the blocks before the current one.
+ * @param double_ended       Set for arenas created with `arena_new_double_ended()`, whose `end` is the high side's position.
+ * @param tags               Hash table of per-tag accounting, `NULL` until the first tagged allocation.
+ * @param tag_capacity       The number of slots in `tags`, a power of two.
+ * @param tag_count          The number of distinct tags recorded.
+ * @param growth             The growth policy sizing new blocks, see `arena_set_growth_policy()`.
+ * @param large_objects      Side list of allocations above `large_threshold`, most recent first.
+ * @param retained           The decayed high-water mark `ARENA_RETAIN_HIGH_WATER` keeps resident.
+ * @param large_count        The number of objects in `large_objects`.
+ * @param large_bytes        The bytes requested by the objects in `large_objects`.
+ * @param zero_mode          When freed memory is zeroed, see `arena_set_zero_mode()`.
+ * @param zero_worker        The background thread of `ARENA_ZERO_ON_RESET_BACKGROUND`, `NULL` otherwise.
+ * @param zeroing            Set while the background thread zeroes the blocks; `end` is clamped to `start`
+ *                           so the next allocation takes the slow path and waits for it.
  * @note
  * - The `current` pointer keeps track of the next available byte for allocation.
- * - When the `current` pointer reaches the end of the memory block (i.e., `current == start + size`),
- *   no further allocations are possible without either resetting or resizing the arena.
+ * - When the `current` pointer reaches `end`, the arena moves on to the next block in the chain,
+ *   allocating a new one if there is no spare block large enough. Pointers returned earlier stay valid.
  */
 typedef struct Arena {
-    char* start;        // Start of the arena memory
+    char* start;        // Start of the current block
     char* current;      // Current allocation position
-    size_t size;        // Total size of the arena
-    // If set to true, then if the allocate in the 
-    //arena and it must grow it will grow by arena->size * 2 + sizeof(OBJECT_TO_BE_ALLOCATED)
-    bool if_size_too_small_double_in_size; 
+    char* end;          // End of the current block
+    char* zero;         // Known-zero watermark of the current block
+    size_t large_threshold; // Size above which allocations bypass the blocks, read by the fast path
+    ArenaCounters counters; // Statistics counters, the ones updated per allocation first
+    size_t size;        // Total size of all blocks
+    ArenaBlock* first;  // First block of the chain
+    ArenaBlock* block;  // Block allocations are served from
+    ArenaBacking backing;       // Where the memory comes from
+    size_t reserved;            // Reserved address space (virtual arenas)
+    size_t commit_granularity;  // Bytes committed at once (virtual arenas)
+    size_t generation;          // Incremented by every reset
+    size_t used_before_block;   // Bytes allocated in the blocks before the current one
+    bool double_ended;          // Single block allocated from both ends, `end` is the high side's position
+    ArenaTagStats* tags;        // Per-tag accounting (ARENA_TAGS), allocated with malloc
+    size_t tag_capacity;        // Slots in tags
+    size_t tag_count;           // Distinct tags recorded
+    ArenaGrowthPolicy growth;   // Sizes new blocks
+    struct ArenaLargeObject* large_objects;  // Allocations above large_threshold, most recent first
+    size_t retained;            // Decayed high-water mark of ARENA_RETAIN_HIGH_WATER
+    size_t large_count;         // Objects in large_objects
+    size_t large_bytes;         // Bytes of the objects in large_objects
+    ArenaZeroMode zero_mode;    // When freed memory is zeroed
+    struct ArenaZeroWorker* zero_worker;  // Background zeroing thread (ARENA_ZERO_ON_RESET_BACKGROUND)
+    bool zeroing;               // Background zeroing in flight, `end` is clamped to `start`
 } Arena;
 
 /**
@@ -52,7 +307,9 @@ typedef struct Arena {
  *         (e.g., due to insufficient system memory).
  *
  * @note
- * - The internal memory block of the arena is allocated using `malloc()`.
+ * - Blocks of 256 KiB and more are mapped directly. A fresh mapping is tracked as known-zero, so
+ *   allocations only clear memory that was handed out before (see `ArenaBlock::zero`). Smaller
+ *   blocks come from `malloc()` and are cleared as they are handed out.
  * - If allocation of either the Arena structure or its memory block fails, any partially 
  *   allocated resources are freed before returning `NULL`.
  *
@@ -66,6 +323,231 @@ typedef struct Arena {
  */
 Arena* arena_new(size_t initial_size, bool if_size_too_small_double_in_size);
 
+/**
+ * @brief Create a new arena whose blocks are backed by huge pages.
+ *
+ * Works like `arena_new()` but maps every block with 2 MiB pages, which greatly reduces TLB
+ * misses for arenas holding large working sets. Block sizes are rounded up to a multiple of
+ * the huge page size.
+ *
+ * @param initial_size The initial size of the arena's memory block in bytes.
+ * @param if_size_too_small_double_in_size Flag if set to true then new blocks double in size.
+ * @param explicit_huge_pages If true, blocks are mapped with `MAP_HUGETLB | MAP_HUGE_2MB` from the reserved
+ *        2 MiB huge page pool, falling back to transparent huge pages when none are available. If false,
+ *        blocks are 2 MiB aligned mappings advised with `madvise(MADV_HUGEPAGE)`.
+ *
+ * @return A pointer to the newly created Arena structure, or `NULL` if the allocation failed.
+ *
+ * @note
+ * - The backing each block actually obtained is recorded in `ArenaBlock::backing` and shown by `arena_print_stats()`.
+ * - On platforms without mmap the blocks are allocated with `malloc()`.
+ */
+Arena* arena_new_huge(size_t initial_size, bool if_size_too_small_double_in_size, bool explicit_huge_pages);
+
+/**
+ * @brief Create a new arena backed by a reserved range of virtual memory.
+ *
+ * Reserves `reserve_size` bytes of address space up front without backing them with memory
+ * and commits pages in chunks of `commit_granularity` bytes as the allocation position crosses
+ * the commit line. The arena is a single contiguous region that never moves, so it can grow to
+ * many gigabytes without copying, while the resident memory stays proportional to what was touched.
+ *
+ * @param reserve_size       The amount of address space to reserve in bytes. This is the hard limit of the arena.
+ * @param commit_granularity The number of bytes to commit at once, rounded up to the page size.
+ *
+ * @return A pointer to the newly created Arena structure, or `NULL` if reserving the address
+ *         range failed or virtual memory is not supported on this platform.
+ *
+ * @note
+ * - Allocations that do not fit into the reserved range fail and return `NULL`.
+ * - `arena_committed()` and `arena_reserved()` report how much of the range is backed by memory.
+ *
+ * @example
+ * Arena* myArena = arena_new_virtual((size_t)64 << 30, 1 << 20);  // Reserve 64 GiB, commit 1 MiB at a time
+ */
+Arena* arena_new_virtual(size_t reserve_size, size_t commit_granularity);
+
+/**
+ * @brief Create a double-ended arena: one pre-sized block allocated from both ends.
+ *
+ * `arena_allocate_low()` (and every other allocation function) bumps upward from the start of the
+ * block, `arena_allocate_high()` bumps downward from its end, and each side can be reset on its own.
+ * Long lived results can be kept at one end and per-iteration temporaries at the other without a
+ * second arena and the cache and TLB footprint of a second region.
+ *
+ * @param size The size of the block in bytes. The arena never grows beyond it.
+ *
+ * @return A pointer to the newly created Arena structure, or `NULL` if the allocation failed.
+ *
+ * @note
+ * - The arena is exhausted when the two sides meet, allocations then return `NULL` on either side.
+ * - `arena_mark()`, `arena_rewind()`, `arena_pop()` and `arena_realloc()` operate on the low side.
+ *
+ * @example
+ * Arena* solver = arena_new_double_ended(1 << 20);
+ * Result* results = arena_allocate_low(solver, count * sizeof(Result), alignof(Result));
+ * for (size_t i = 0; i < iterations; i++) {
+ *     float* scratch = arena_allocate_high(solver, 4096, alignof(float));
+ *     // ...
+ *     arena_reset_high(solver);
+ * }
+ */
+Arena* arena_new_double_ended(size_t size);
+
+/**
+ * @brief Serve allocations above a size threshold from dedicated mappings instead of the arena's blocks.
+ *
+ * Without a threshold a single multi-megabyte allocation makes the arena chain a block at least as
+ * large, and after the next reset that block mostly sits empty. With a threshold such allocations get
+ * their own `mmap` (or `malloc` where unavailable), tracked in a per-arena side list and released by
+ * `arena_reset()`, `arena_rewind()` and `arena_free()`. The blocks stay sized for the common small
+ * allocations and stay hot in cache.
+ *
+ * @param arena     Pointer to the Arena structure.
+ * @param threshold Allocations of more than this many bytes bypass the blocks, 0 disables the bypass (the default).
+ *
+ * @note
+ * - Fresh mappings are already zeroed, so zeroed large allocations cost no `memset`.
+ * - Large objects are not on top of the arena: `arena_pop()` and in-place `arena_realloc()` do not apply to them.
+ *
+ * @example
+ * arena_set_large_threshold(frameArena, 256 * 1024);
+ * float* image = arena_allocate(frameArena, 16 << 20, 64);  // Own mapping, unmapped by the next reset
+ */
+void arena_set_large_threshold(Arena* arena, size_t threshold);
+
+/**
+ * @brief Set the policy that sizes the blocks the arena chains as it grows.
+ *
+ * Arenas start with geometric growth by a factor of 2 if created with `if_size_too_small_double_in_size`,
+ * and a factor of 1 (blocks of the same size) otherwise.
+ *
+ * @param arena  Pointer to the Arena structure.
+ * @param policy The policy to copy into the arena. A geometric factor below 1.0 is treated as 1.0.
+ *
+ * @note Virtual and double-ended arenas never chain blocks. Only `max_size` applies to them, and
+ *       only to virtual arenas, as a limit below the reserved size.
+ *
+ * @example
+ * ArenaGrowthPolicy policy = { ARENA_GROWTH_GEOMETRIC, 1.5, 0, 64 << 20, 1 << 30, NULL, NULL };
+ * arena_set_growth_policy(myArena, &policy);  // Grow by 1.5x, blocks of at most 64 MiB, 1 GiB in total
+ */
+void arena_set_growth_policy(Arena* arena, const ArenaGrowthPolicy* policy);
+
+/**
+ * @brief Choose whether zeroing is paid per allocation or once in bulk at reset.
+ *
+ * By default every allocation below the known-zero watermark is cleared with `memset`, so an arena
+ * that is filled and reset every frame zeroes its memory piecemeal, through the cache, right before
+ * each object is written. With `ARENA_ZERO_ON_RESET`, `arena_reset()` and `arena_reset_trim()` clear
+ * everything handed out since the memory was last known to be zero in one pass, using non-temporal
+ * (cache bypassing) stores for large ranges where available. The watermark then drops to the start
+ * of every block and allocations skip their `memset` entirely.
+ *
+ * `ARENA_ZERO_ON_RESET_BACKGROUND` hands that pass to a thread owned by the arena, so the reset
+ * returns right away. The next operation that needs the blocks (any allocation that does not fit
+ * the fast path, which is all of them until the pass is done, `arena_rewind()`, `arena_grow()` or
+ * the next reset) waits for the pass to finish.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @param mode  The zeroing mode.
+ * @return `ARENA_SUCCESS`, or `ARENA_ERROR_ALLOCATION_FAILED` if the background thread could not be
+ *         started; the arena then keeps its previous mode.
+ *
+ * @note
+ * - Double-ended arenas always zero on allocation, the mode has no effect on them.
+ * - Memory that is zeroed at reset but never reused is zeroed for nothing; the mode pays off for
+ *   arenas that are refilled to roughly the same level after every reset.
+ * - Without POSIX threads the background mode zeroes synchronously, like `ARENA_ZERO_ON_RESET`.
+ *
+ * @example
+ * arena_set_zero_mode(frameArena, ARENA_ZERO_ON_RESET_BACKGROUND);
+ * arena_reset(frameArena);  // Returns immediately, the frame's memory is cleared while input is polled
+ */
+ArenaError arena_set_zero_mode(Arena* arena, ArenaZeroMode mode);
+
+/**
+ * @brief Resize an allocation, in place when it is the most recent one.
+ *
+ * If `ptr` is the last allocation made from the arena, it is resized by just moving the arena's
+ * allocation position, so a dynamic array or string builder growing at the top of the arena never
+ * copies. Otherwise shrinking returns `ptr` unchanged and growing allocates a new block and copies
+ * the old contents, leaving the old block as dead space until the next reset.
+ *
+ * @param arena     Pointer to the Arena structure `ptr` was allocated from.
+ * @param ptr       The allocation to resize, or `NULL` to allocate a new block.
+ * @param old_size  The current size of the allocation in bytes.
+ * @param new_size  The desired size of the allocation in bytes.
+ * @param alignment The alignment `ptr` was allocated with (must be a power of two).
+ *
+ * @return A pointer to the resized allocation, or `NULL` if the arena could not grow (`ptr` stays valid).
+ *
+ * @note
+ * - The first `min(old_size, new_size)` bytes are preserved, bytes beyond `old_size` are zeroed.
+ *
+ * @example
+ * char* text = arena_allocate(myArena, 16, 1);
+ * text = arena_realloc(myArena, text, 16, 64, 1);  // extends in place, nothing is copied
+ */
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size, size_t alignment);
+
+// Attempt to grow the arena by the given size (in bytes) by chaining a spare block after the current one,
+// or for virtual arenas by committing more of the reserved range. Memory already handed out does not move.
+// Returns ARENA_SUCCESS on success, ARENA_ERROR_REALLOCATION_FAILED on failure.
+ArenaError arena_grow(Arena* arena, size_t additional_size); 
+
+// Slow path of `arena_allocate_ex()`, called by the inline fast path when the current block
+// cannot hold the allocation. Applies the flags, grows the arena if needed and allocates.
+ARENA_ATTR_COLD void* arena_allocate_slow(Arena* arena, size_t size, size_t alignment, unsigned int flags);
+
+/**
+ * @brief Allocate aligned memory of the given size from the arena, controlled by flags.
+ *
+ * Works like `arena_allocate()`, which is a convenience wrapper for `arena_allocate_ex(arena, size, alignment, ARENA_ALLOC_DEFAULT)`,
+ * but lets the caller opt out of zeroing, forbid growth or request cache line or page alignment.
+ * Skipping the zeroing of large scratch buffers that are overwritten right away halves the memory
+ * bandwidth spent on the allocation.
+ *
+ * @param arena     Pointer to the Arena structure from which to allocate memory.
+ * @param size      The desired size of the memory block in bytes.
+ * @param alignment The desired alignment of the memory block (must be a power of two).
+ * @param flags     A combination of `ArenaAllocFlags`.
+ *
+ * @return A pointer to the newly allocated and aligned memory block, or `NULL` if the allocation failed
+ *         (e.g., because `ARENA_ALLOC_NO_GROW` was given and the arena is out of space).
+ *
+ * @note
+ * - With `ARENA_ALLOC_NO_GROW` the arena still moves on to a spare block that is already part of its chain.
+ *
+ * @example
+ * float* scratch = arena_allocate_ex(myArena, 8 << 20, 4, ARENA_ALLOC_NO_ZERO | ARENA_ALLOC_ALIGN_PAGE);
+ */
+ARENA_ATTR_MALLOC ARENA_ATTR_ALLOC_SIZE(2) ARENA_ATTR_ALLOC_ALIGN(3)
+static inline void* arena_allocate_ex(Arena* arena, size_t size, size_t alignment, unsigned int flags) {
+    // Apply the alignment presets, with constant flags this folds away
+    if ((flags & ARENA_ALLOC_ALIGN_CACHE_LINE) && alignment < ARENA_CACHE_LINE_SIZE) alignment = ARENA_CACHE_LINE_SIZE;
+    if ((flags & ARENA_ALLOC_ALIGN_PAGE) && alignment < ARENA_PAGE_SIZE) alignment = ARENA_PAGE_SIZE;
+
+    // Bytes needed to align the current position, alignment is a power of two
+    size_t adjustment = (size_t)(-(uintptr_t)arena->current) & (alignment - 1);
+    size_t available = (size_t)(arena->end - arena->current);
+
+    if (ARENA_LIKELY(size <= available && adjustment <= available - size && size <= arena->large_threshold)) {
+        char* ptr = arena->current + adjustment;
+        arena->current = ptr + size;
+#if ARENA_STATS
+        arena->counters.allocations++;
+        arena->counters.bytes_requested += size;
+        arena->counters.bytes_padding += adjustment;
+#endif
+        if (!(flags & ARENA_ALLOC_NO_ZERO) && ptr < arena->zero) {
+            memset(ptr, 0, size); // Only memory below the known-zero watermark can be dirty
+        }
+        return ptr;
+    }
+    return arena_allocate_slow(arena, size, alignment, flags);
+}
+
 /**
  * @brief Allocate aligned memory of the given size from the arena.
  *
@@ -81,10 +563,14 @@ Arena* arena_new(size_t initial_size, bool if_size_too_small_double_in_size);
  *         (e.g., due to insufficient space in the arena or an invalid alignment).
  *
  * @note
- * - The allocated memory block is automatically initialized to zero.
+ * - The allocated memory block is automatically initialized to zero. Memory that has never been
+ *   handed out since its block was mapped is known to be zero already and is not cleared again.
  * - If the requested alignment is 1, no alignment adjustment is performed for efficiency.
- * - The arena may be automatically resized if there is insufficient space to fulfill the request.
- * How much the arena resizes is based on the if_size_too_small_double_in_size flag.
+ * - This function is inlined. When the allocation fits into the current block it compiles down to
+ *   a mask-based align and bump; only growing the arena calls into the library.
+ * - The arena may automatically chain a new block if there is insufficient space to fulfill the request.
+ * How large the new block is, is decided by the arena's growth policy (see `arena_set_growth_policy()`). Previously
+ * allocated memory is never moved.
  *
  * @example
  * Arena myArena;
@@ -95,31 +581,324 @@ Arena* arena_new(size_t initial_size, bool if_size_too_small_double_in_size);
  *     // Use the allocated memory...
  * }
  */
-void* arena_allocate(Arena* arena, size_t size, size_t alignment);
+ARENA_ATTR_MALLOC ARENA_ATTR_ALLOC_SIZE(2) ARENA_ATTR_ALLOC_ALIGN(3)
+static inline void* arena_allocate(Arena* arena, size_t size, size_t alignment) {
+    return arena_allocate_ex(arena, size, alignment, ARENA_ALLOC_DEFAULT);
+}
 
-// Attempt to grow the arena by the given size (in bytes). Returns ARENA_SUCCESS on success, ARENA_ERROR_REALLOCATION_FAILED on failure.
-ArenaError arena_grow(Arena* arena, size_t additional_size); 
+// Raises the known-zero watermark to `current`, called before `current` moves back.
+static inline void arena_track_zero(Arena* arena) {
+    if (arena->current > arena->zero) { arena->zero = arena->current; }
+}
+
+// Records the current usage in the high-water mark, called before memory is released.
+static inline void arena_track_high_water(Arena* arena) {
+#if ARENA_STATS
+    size_t used = arena->used_before_block + (size_t)(arena->current - arena->start);
+    if (arena->double_ended) { used += (size_t)(arena->block->end - arena->end); }
+    if (used > arena->counters.high_water) { arena->counters.high_water = used; }
+#else
+    (void)arena;
+#endif
+}
+
+/**
+ * @brief Release `[ptr, ptr + size)` if it is the top-most allocation, without counting a miss otherwise.
+ *
+ * Same as `arena_pop()` below, for callers that free in arbitrary order and only opportunistically reclaim
+ * the top, such as the C++ container adapters. Their out of order frees are expected and would
+ * drown the misses of real LIFO users in `ArenaStats::pop_misses`.
+ *
+ * @param arena Pointer to the Arena structure `ptr` was allocated from.
+ * @param ptr   The allocation to release.
+ * @param size  The size the allocation was made with.
+ * @return `true` if the allocation was on top and has been released.
+ */
+static inline bool arena_try_pop(Arena* arena, void* ptr, size_t size) {
+    char* begin = (char*)ptr;
+    if (ARENA_LIKELY(begin >= arena->start && begin + size == arena->current)) {
+        arena_track_high_water(arena);
+        arena_track_zero(arena);
+        arena->current = begin;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Release the most recent allocation, using the arena as a stack.
+ *
+ * If `[ptr, ptr + size)` is the top-most allocation of the arena, the allocation position is rolled
+ * back to `ptr` so the memory is reused by the next allocation. Recursive algorithms that allocate and
+ * release in LIFO order thereby get a stack allocator without a separate data structure.
+ *
+ * @param arena Pointer to the Arena structure `ptr` was allocated from.
+ * @param ptr   The allocation to release.
+ * @param size  The size the allocation was made with.
+ *
+ * @note
+ * - When `ptr` is not on top, the call is a no-op that is counted in `ArenaStats::pop_misses`, so callers can
+ *   pop unconditionally. The memory is then released with the next reset.
+ * - Padding inserted before `ptr` for alignment is not reclaimed.
+ *
+ * @example
+ * Node* node = arena_allocate(myArena, sizeof(Node), alignof(Node));
+ * parse_children(myArena, node);
+ * arena_pop(myArena, node, sizeof(Node));
+ */
+static inline void arena_pop(Arena* arena, void* ptr, size_t size) {
+    if (ARENA_LIKELY(arena_try_pop(arena, ptr, size))) { return; }
+#if ARENA_STATS
+    arena->counters.pop_misses++;
+#endif
+}
+
+/**
+ * @brief Allocate from the low side of a double-ended arena, bumping upward from its start.
+ *
+ * Identical to `arena_allocate()`, named for symmetry with `arena_allocate_high()`.
+ *
+ * @return A pointer to zeroed memory, or `NULL` if the low side reached the high side.
+ */
+ARENA_ATTR_MALLOC ARENA_ATTR_ALLOC_SIZE(2) ARENA_ATTR_ALLOC_ALIGN(3)
+static inline void* arena_allocate_low(Arena* arena, size_t size, size_t alignment) {
+    return arena_allocate_ex(arena, size, alignment, ARENA_ALLOC_DEFAULT);
+}
+
+/**
+ * @brief Allocate from the high side of a double-ended arena, bumping downward from its end.
+ *
+ * @param arena     Pointer to an Arena created with `arena_new_double_ended()`.
+ * @param size      The desired size of the memory block in bytes.
+ * @param alignment The desired alignment of the memory block (must be a power of two).
+ *
+ * @return A pointer to zeroed memory, or `NULL` if the high side reached the low side.
+ */
+ARENA_ATTR_MALLOC ARENA_ATTR_ALLOC_SIZE(2) ARENA_ATTR_ALLOC_ALIGN(3)
+static inline void* arena_allocate_high(Arena* arena, size_t size, size_t alignment) {
+    if (ARENA_UNLIKELY(size > (size_t)(arena->end - arena->current))) { return NULL; }
+
+    char* ptr = (char*)((uintptr_t)(arena->end - size) & ~(uintptr_t)(alignment - 1));
+    if (ARENA_UNLIKELY(ptr < arena->current)) { return NULL; }
+
+#if ARENA_STATS
+    arena->counters.allocations++;
+    arena->counters.bytes_requested += size;
+    arena->counters.bytes_padding += (size_t)(arena->end - ptr) - size;
+#endif
+    arena->end = ptr;
+    memset(ptr, 0, size);
+    return ptr;
+}
+
+// Adds an allocation of `size` bytes to the accounting of `tag`. Called by `arena_allocate_tagged()`.
+void arena_tag_record(Arena* arena, const char* tag, size_t size);
+
+// Expands to a tag naming the call site, e.g. "src/physics.c:42".
+#define ARENA_TAG_STRINGIFY_(x) #x
+#define ARENA_TAG_STRINGIFY(x)  ARENA_TAG_STRINGIFY_(x)
+#define ARENA_TAG_HERE          (__FILE__ ":" ARENA_TAG_STRINGIFY(__LINE__))
+
+/**
+ * @brief Allocate zeroed, aligned memory and account it to a tag.
+ *
+ * Works like `arena_allocate()` and, when built with `ARENA_TAGS=1`, adds the allocation to the
+ * per-tag table of the arena, so it can be told which subsystem or call site made an arena balloon.
+ * Otherwise the tag is ignored and the call is exactly `arena_allocate()`.
+ *
+ * @param arena     Pointer to the Arena structure from which to allocate memory.
+ * @param size      The desired size of the memory block in bytes.
+ * @param alignment The desired alignment of the memory block (must be a power of two).
+ * @param tag       A string naming the subsystem, or `ARENA_TAG_HERE` for the call site. It must
+ *                  outlive the arena, string literals are the intended use. Equal strings share one entry.
+ *
+ * @return A pointer to the newly allocated memory block, or `NULL` if the allocation failed.
+ *
+ * @example
+ * Contact* contacts = arena_allocate_tagged(frame, count * sizeof(Contact), alignof(Contact), "physics");
+ * char* line = arena_allocate_tagged(frame, 256, 1, ARENA_TAG_HERE);
+ * arena_print_tag_stats(frame);
+ */
+ARENA_ATTR_MALLOC ARENA_ATTR_ALLOC_SIZE(2) ARENA_ATTR_ALLOC_ALIGN(3)
+static inline void* arena_allocate_tagged(Arena* arena, size_t size, size_t alignment, const char* tag) {
+    void* ptr = arena_allocate_ex(arena, size, alignment, ARENA_ALLOC_DEFAULT);
+#if ARENA_TAGS
+    if (ptr) { arena_tag_record(arena, tag, size); }
+#else
+    (void)tag;
+#endif
+    return ptr;
+}
 
 /**
  * @brief Resets the arena to its initial state.
  *
  * This function resets the arena's internal position pointer (`current`) back to 
- * the beginning of the arena's memory block (`start`). This effectively makes all 
+ * the beginning of the arena's first memory block. This effectively makes all 
  * previously allocated memory within the arena available for reuse.
  *
  * @param arena Pointer to the Arena structure to be reset.
  *
  * @note
- * - This function does not deallocate any memory. The arena's total capacity remains unchanged.
+ * - This function does not deallocate any memory. The arena's total capacity remains unchanged,
+ *   blocks after the first one are kept and recycled by subsequent allocations.
  * - Data in the previously allocated memory blocks is not cleared or erased; it becomes 
- *   accessible for overwriting in subsequent allocations.
+ *   accessible for overwriting in subsequent allocations. Arenas set to `ARENA_ZERO_ON_RESET`
+ *   or `ARENA_ZERO_ON_RESET_BACKGROUND` with `arena_set_zero_mode()` clear it here instead.
  */
 void arena_reset(Arena* arena);
 
+/**
+ * @brief Release everything allocated from the low side of a double-ended arena.
+ *
+ * @param arena Pointer to an Arena created with `arena_new_double_ended()`.
+ *
+ * @note Like `arena_reset()`, this starts a new arena generation, so pools and slabs built on the arena start over.
+ */
+void arena_reset_low(Arena* arena);
+
+/**
+ * @brief Release everything allocated from the high side of a double-ended arena.
+ *
+ * @param arena Pointer to an Arena created with `arena_new_double_ended()`.
+ */
+void arena_reset_high(Arena* arena);
+
+/**
+ * ArenaRetentionKind: How much memory `arena_reset_trim()` keeps resident.
+ */
+typedef enum {
+    ARENA_RETAIN_ALL,       /** Keep everything, like `arena_reset()`. */
+    ARENA_RETAIN_BYTES,     /** Keep the first `bytes` bytes. */
+    ARENA_RETAIN_HIGH_WATER /** Keep the recent high-water mark: the larger of the usage at this reset and the
+                                previously kept amount multiplied by `decay`, so a spike is released gradually. */
+} ArenaRetentionKind;
+
+/**
+ * @brief The retention policy of `arena_reset_trim()`.
+ *
+ * @param kind  How much memory is kept.
+ * @param bytes `ARENA_RETAIN_BYTES`: the number of bytes to keep.
+ * @param decay `ARENA_RETAIN_HIGH_WATER`: factor from 0.0 to 1.0 applied to the kept amount on every reset.
+ * @param lazy  Return pages with `MADV_FREE`, which the kernel reclaims only under memory pressure,
+ *              instead of `MADV_DONTNEED`, which releases them right away. Lazily returned pages may
+ *              keep their contents, so the zero modes of `arena_set_zero_mode()` do not clear them at
+ *              reset; they are zeroed when they are allocated again.
+ */
+typedef struct ArenaRetention {
+    ArenaRetentionKind kind;  // How much memory is kept
+    size_t bytes;             // Bytes kept by ARENA_RETAIN_BYTES
+    float decay;              // Decay of ARENA_RETAIN_HIGH_WATER
+    bool lazy;                // MADV_FREE instead of MADV_DONTNEED
+} ArenaRetention;
+
+/**
+ * @brief Reset the arena and return memory beyond what the retention policy keeps to the system.
+ *
+ * `arena_reset()` keeps everything the arena ever grew to, so a single spike stays resident forever.
+ * This variant resets the arena and then trims it down to the amount the policy keeps: chained
+ * arenas free their surplus blocks, mmap-backed blocks and virtual arenas hand the pages beyond it
+ * back to the kernel with `madvise()`. Virtual arenas also decommit those pages, which are committed
+ * again on demand.
+ *
+ * @param arena     Pointer to the Arena structure to be reset.
+ * @param retention The retention policy.
+ *
+ * @note
+ * - The first block of a chained arena is always kept. Blocks are kept in chain order until the
+ *   retained amount is reached, the remaining ones are freed.
+ * - The bytes returned are counted in `ArenaStats::bytes_trimmed`.
+ *
+ * @example
+ * ArenaRetention retention = { ARENA_RETAIN_HIGH_WATER, 0, 0.9f, false };
+ * arena_reset_trim(requestArena, &retention);  // A spike is released over a few dozen requests
+ */
+void arena_reset_trim(Arena* arena, const ArenaRetention* retention);
+
+/**
+ * @brief A saved allocation position of an arena, created by `arena_mark()`.
+ *
+ * @param block   The block that was current when the mark was taken.
+ * @param current The allocation position inside that block.
+ * @param used_before_block The bytes allocated in the blocks before `block`, restored by `arena_rewind()`.
+ * @param large_objects The most recent large object, the ones allocated later are released by `arena_rewind()`.
+ */
+typedef struct ArenaMark {
+    ArenaBlock* block;  // Block that was current when the mark was taken
+    char* current;      // Allocation position inside that block
+    size_t used_before_block;  // Bytes allocated in the blocks before that block
+    struct ArenaLargeObject* large_objects;  // Most recent large object when the mark was taken
+} ArenaMark;
+
+/**
+ * @brief Record the current allocation position of the arena.
+ *
+ * Pass the returned mark to `arena_rewind()` to release everything allocated after this call
+ * while keeping everything allocated before it.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @return A mark describing the current position, including the block in a multi-block arena.
+ */
+ArenaMark arena_mark(const Arena* arena);
+
+/**
+ * @brief Roll the arena back to a position recorded with `arena_mark()`.
+ *
+ * Everything allocated after the mark becomes available for reuse in O(1). Blocks the arena
+ * chained after the mark are kept as spare blocks, exactly as `arena_reset()` does.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @param mark  A mark taken from the same arena.
+ *
+ * @note A mark is invalidated by `arena_reset()` and by rewinding to a mark that was taken before it.
+ *
+ * @example
+ * ArenaMark mark = arena_mark(myArena);
+ * char* scratch = arena_allocate(myArena, 4096, 1);
+ * // ... use scratch ...
+ * arena_rewind(myArena, mark);  // scratch is released, earlier allocations are untouched
+ */
+void arena_rewind(Arena* arena, ArenaMark mark);
+
+/**
+ * @brief A scope of temporary allocations inside a longer lived arena.
+ *
+ * @param arena The arena the temporary allocations come from.
+ * @param mark  The position of the arena when the scope began.
+ */
+typedef struct ArenaTemp {
+    Arena* arena;    // Arena the temporary allocations come from
+    ArenaMark mark;  // Position of the arena when the scope began
+} ArenaTemp;
+
+/**
+ * @brief Begin a scope of temporary allocations.
+ *
+ * Allocate from `temp.arena` as usual, then call `arena_temp_end()` to release everything that
+ * was allocated since the scope began. Scopes can be nested as long as they end in reverse order.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @return The scope, to be passed to `arena_temp_end()`.
+ *
+ * @example
+ * ArenaTemp temp = arena_temp_begin(myArena);
+ * int* indices = arena_allocate(temp.arena, count * sizeof(int), sizeof(int));
+ * // ...
+ * arena_temp_end(temp);
+ */
+ArenaTemp arena_temp_begin(Arena* arena);
+
+/**
+ * @brief End a scope of temporary allocations, releasing everything allocated inside it.
+ *
+ * @param temp The scope returned by `arena_temp_begin()`.
+ */
+void arena_temp_end(ArenaTemp temp);
+
 /**
  * @brief Frees all memory associated with the arena.
  *
- * Deallocates the internal memory block used by the arena and then frees the Arena structure itself.
+ * Deallocates every memory block in the arena's chain and then frees the Arena structure itself.
  * After this call, the arena pointer becomes invalid and should not be used.
  *
  * @param arena Pointer to the Arena structure to be freed.
@@ -131,8 +910,10 @@ void arena_free(Arena* arena);
 /**
  * @brief Get the available space in the arena.
  *
- * Returns the number of bytes currently available for allocation in the arena. This
- * does not include any memory that might be freed up by resetting the arena.
+ * Returns the number of bytes currently available for allocation in the arena, that is the free
+ * space of the current block plus the size of all spare blocks after it. This does not include
+ * any memory that might be freed up by resetting the arena, nor the unused tails of blocks the
+ * arena already moved past.
  *
  * @param arena Pointer to the Arena structure.
  * @return The available space in the arena (in bytes).
@@ -142,18 +923,40 @@ size_t arena_available(const Arena* arena);
 /**
  * @brief Get the used space in the arena.
  *
- * Returns the number of bytes currently allocated in the arena. This includes any memory
- * that has been allocated but not yet freed, even if it's currently unused due to a reset.
+ * Returns the number of bytes currently allocated in the arena, summed over every block
+ * from the first one up to the current one.
  *
  * @param arena Pointer to the Arena structure.
  * @return The used space in the arena (in bytes).
  */
 size_t arena_used(const Arena* arena);
 
+/**
+ * @brief Get the committed size of the arena.
+ *
+ * Returns the number of bytes backed by memory. For virtual arenas this is the committed part
+ * of the reserved range, for all other arenas it is the total size of all blocks.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @return The committed size of the arena (in bytes).
+ */
+size_t arena_committed(const Arena* arena);
+
+/**
+ * @brief Get the reserved size of the arena.
+ *
+ * Returns the size of the reserved address range for virtual arenas. For all other arenas
+ * this is equal to `arena_committed()`.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @return The reserved size of the arena (in bytes).
+ */
+size_t arena_reserved(const Arena* arena);
+
 /**
  * @brief Get the utilization of the arena.
  *
- * Returns the percentage of the arena's total capacity that is currently in use.
+ * Returns the fraction of the arena's total capacity that is currently in use.
  *
  * @param arena Pointer to the Arena structure.
  * @return The utilization of the arena as a floating-point value (0.0 to 1.0).
@@ -164,10 +967,91 @@ float arena_utilization(const Arena* arena);
  * @brief Print statistics about the arena's usage.
  *
  * Prints a summary of the arena's usage to standard output, including the total size,
- * used space, available space, and utilization percentage. This is mainly a debugging tool.
+ * used space, available space, and utilization percentage, and which backing the blocks
+ * actually obtained. Virtual arenas additionally print their committed and reserved size, and
+ * unless built with `ARENA_STATS=0` the counters of `arena_get_stats()` follow. This is mainly a debugging tool.
  *
  * @param arena Pointer to the Arena structure.
  */
 void arena_print_stats(const Arena* arena);
 
+/**
+ * @brief Get a snapshot of the arena's statistics.
+ *
+ * @param arena Pointer to the Arena structure.
+ * @return The statistics of the arena, see `ArenaStats`.
+ *
+ * @example
+ * ArenaStats stats = arena_get_stats(myArena);
+ * printf("%zu allocations, %zu bytes wasted on padding\n", stats.allocations, stats.bytes_padding);
+ */
+ArenaStats arena_get_stats(const Arena* arena);
+
+/**
+ * @brief Copy the per-tag accounting of `arena_allocate_tagged()`, largest byte count first.
+ *
+ * @param arena    Pointer to the Arena structure.
+ * @param out      Array receiving up to `capacity` entries, may be `NULL` when `capacity` is 0.
+ * @param capacity The number of entries `out` can hold.
+ * @return The total number of distinct tags, which can exceed `capacity`. Always 0 unless built with `ARENA_TAGS=1`.
+ */
+size_t arena_get_tag_stats(const Arena* arena, ArenaTagStats* out, size_t capacity);
+
+/**
+ * @brief Print the per-tag accounting of `arena_allocate_tagged()`, largest byte count first.
+ *
+ * @param arena Pointer to the Arena structure.
+ */
+void arena_print_tag_stats(const Arena* arena);
+
+#define ARENA_THREAD_LOCAL_DEFAULT_SIZE (64 * 1024)  // Initial size of thread local arenas unless configured otherwise
+
+/**
+ * @brief Get the calling thread's default arena.
+ *
+ * Every thread has its own arena that is created lazily on the first call and freed automatically
+ * when the thread exits. Because no other thread ever touches it, allocating from it needs no
+ * synchronization, and code running on a thread pool does not have to pass an arena pointer around.
+ *
+ * @return A pointer to the calling thread's arena, or `NULL` if it could not be created.
+ *
+ * @note
+ * - The arena must not be freed with `arena_free()`, use `arena_thread_local_free()` instead.
+ * - Thread exit destructors do not run for the main thread when the process exits; its arena is
+ *   released together with the process unless `arena_thread_local_free()` is called.
+ * - The cleanup at thread exit needs POSIX threads. On other platforms every thread has to call
+ *   `arena_thread_local_free()` before it exits, or its arena leaks.
+ *
+ * @example
+ * Arena* scratch = arena_thread_local();
+ * char* buffer = arena_allocate(scratch, 256, 1);
+ * // ...
+ * arena_reset(scratch);
+ */
+Arena* arena_thread_local(void);
+
+/**
+ * @brief Configure the arenas created by `arena_thread_local()`.
+ *
+ * Sets the initial size and growth flag used for thread local arenas that are created after this call.
+ * Arenas that already exist keep their configuration. Call this during startup before worker threads
+ * begin allocating, it is not synchronized with `arena_thread_local()`.
+ *
+ * @param initial_size The initial size of every thread's arena in bytes.
+ * @param if_size_too_small_double_in_size Flag if set to true then new blocks double in size.
+ */
+void arena_thread_local_configure(size_t initial_size, bool if_size_too_small_double_in_size);
+
+/**
+ * @brief Free the calling thread's default arena before the thread exits.
+ *
+ * The next call to `arena_thread_local()` on this thread creates a new arena. Does nothing if the
+ * thread has no arena.
+ */
+void arena_thread_local_free(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif // ARENA_H
\ No newline at end of file
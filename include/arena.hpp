@@ -0,0 +1,196 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include "arena.h"
+
+#include <cstddef>      // for std::size_t
+#include <limits>       // for std::numeric_limits
+#include <new>          // for placement new and std::bad_alloc
+#include <type_traits>  // for the triviality traits
+#include <utility>      // for std::forward and std::exchange
+
+namespace arena {
+
+/**
+ * @brief Owning C++ wrapper around the C `Arena`.
+ *
+ * Frees the arena in its destructor, so arenas no longer leak when an exception unwinds the stack.
+ * The wrapper is move-only: exactly one object owns the underlying `::Arena*` at any time.
+ * Allocation failures throw `std::bad_alloc` instead of returning `nullptr`.
+ *
+ * @note
+ * - The arena never runs destructors, so the typed allocation templates only accept trivially
+ *   destructible types.
+ * - Memory is only zeroed when zero bytes are the initialization. When a constructor initializes
+ *   the object, the `memset` that `arena_allocate()` would perform is skipped.
+ *
+ * @example
+ * arena::Arena frame(64 * 1024);
+ * Particle* p = frame.make<Particle>(position, velocity);
+ * float* weights = frame.make_array<float>(count);       // zeroed
+ * char* text = frame.uninitialized_array<char>(length);  // not initialized at all
+ */
+class Arena {
+public:
+    // Creates an arena with `arena_new()`.
+    explicit Arena(std::size_t initial_size, bool if_size_too_small_double_in_size = true)
+        : arena_(arena_new(initial_size, if_size_too_small_double_in_size)) {
+        if (!arena_) { throw std::bad_alloc(); }
+    }
+
+    // Takes ownership of an arena created by any of the C constructors, e.g. `arena_new_virtual()`.
+    explicit Arena(::Arena* arena) noexcept : arena_(arena) {}
+
+    ~Arena() {
+        if (arena_) { arena_free(arena_); }
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    Arena(Arena&& other) noexcept : arena_(std::exchange(other.arena_, nullptr)) {}
+
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            if (arena_) { arena_free(arena_); }
+            arena_ = std::exchange(other.arena_, nullptr);
+        }
+        return *this;
+    }
+
+    // The underlying C arena, still owned by this object.
+    ::Arena* get() const noexcept { return arena_; }
+
+    // Gives up ownership of the underlying C arena, the caller must free it.
+    ::Arena* release() noexcept { return std::exchange(arena_, nullptr); }
+
+    // Allocates raw memory, see `arena_allocate_ex()`. Throws `std::bad_alloc` on failure.
+    void* allocate(std::size_t size, std::size_t alignment, unsigned int flags = ARENA_ALLOC_DEFAULT) {
+        void* ptr = arena_allocate_ex(arena_, size, alignment, flags);
+        if (!ptr) { throw std::bad_alloc(); }
+        return ptr;
+    }
+
+    // Releases the top-most allocation, see `arena_pop()`.
+    void pop(void* ptr, std::size_t size) noexcept { arena_pop(arena_, ptr, size); }
+
+    // Allocates and constructs a single `T` from `args`.
+    template <typename T, typename... Args>
+    T* make(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "the arena never runs destructors");
+        void* ptr = allocate(sizeof(T), alignof(T), ARENA_ALLOC_NO_ZERO);
+        if constexpr (std::is_constructible<T, Args...>::value) {
+            return ::new (ptr) T(std::forward<Args>(args)...);
+        } else {
+            return ::new (ptr) T{std::forward<Args>(args)...};
+        }
+    }
+
+    // Allocates `count` value-initialized `T`. Trivial types are zeroed in one go instead of being constructed one by one.
+    template <typename T>
+    T* make_array(std::size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "the arena never runs destructors");
+        if constexpr (std::is_trivially_default_constructible<T>::value) {
+            return static_cast<T*>(allocate(array_size<T>(count), alignof(T)));
+        } else {
+            T* array = static_cast<T*>(allocate(array_size<T>(count), alignof(T), ARENA_ALLOC_NO_ZERO));
+            for (std::size_t i = 0; i < count; ++i) { ::new (static_cast<void*>(array + i)) T(); }
+            return array;
+        }
+    }
+
+    // Allocates `count` `T` without initializing or zeroing them.
+    template <typename T>
+    T* uninitialized_array(std::size_t count) {
+        static_assert(std::is_trivially_default_constructible<T>::value && std::is_trivially_destructible<T>::value,
+                      "uninitialized arrays are only allowed for trivial types");
+        return static_cast<T*>(allocate(array_size<T>(count), alignof(T), ARENA_ALLOC_NO_ZERO));
+    }
+
+    void reset() noexcept { arena_reset(arena_); }
+    ArenaMark mark() const noexcept { return arena_mark(arena_); }
+    void rewind(ArenaMark mark) noexcept { arena_rewind(arena_, mark); }
+
+    std::size_t used() const noexcept { return arena_used(arena_); }
+    std::size_t available() const noexcept { return arena_available(arena_); }
+    ArenaStats stats() const noexcept { return arena_get_stats(arena_); }
+
+private:
+    template <typename T>
+    static std::size_t array_size(std::size_t count) {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) { throw std::bad_alloc(); }
+        return count * sizeof(T);
+    }
+
+    ::Arena* arena_;
+};
+
+/**
+ * @brief A stateful allocator satisfying the standard Allocator requirements on top of an `Arena`.
+ *
+ * Lets containers that are not on `std::pmr` allocate from an arena, e.g.
+ * `std::vector<T, arena::Allocator<T>>` or `std::map<K, V, std::less<K>, arena::Allocator<std::pair<const K, V>>>`.
+ * Node based containers benefit most: consecutive nodes end up next to each other in memory.
+ * The allocator does not own the arena; it must outlive every container that uses the allocator.
+ *
+ * @note
+ * - Two allocators compare equal when they allocate from the same `::Arena*`, for any `T`.
+ * - The allocator propagates on copy assignment, move assignment and swap, so containers never
+ *   end up holding memory from an arena they do not reference.
+ * - Memory is not zeroed. `deallocate()` is a no-op unless it releases the most recent allocation.
+ *
+ * @example
+ * arena::Arena nodes(1 << 20);
+ * std::map<int, float, std::less<int>, arena::Allocator<std::pair<const int, float>>> weights(nodes);
+ */
+template <typename T>
+class Allocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    template <typename U>
+    struct rebind {
+        using other = Allocator<U>;
+    };
+
+    Allocator(::Arena* arena) noexcept : arena_(arena) {}
+    Allocator(Arena& arena) noexcept : arena_(arena.get()) {}
+
+    template <typename U>
+    Allocator(const Allocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(std::size_t count) {
+        if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) { throw std::bad_alloc(); }
+        void* ptr = arena_allocate_ex(arena_, count * sizeof(T), alignof(T), ARENA_ALLOC_NO_ZERO);
+        if (!ptr) { throw std::bad_alloc(); }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, std::size_t count) noexcept {
+        arena_try_pop(arena_, ptr, count * sizeof(T)); // Frees out of LIFO order are expected, not misses
+    }
+
+    // The arena this allocator allocates from.
+    ::Arena* arena() const noexcept { return arena_; }
+
+private:
+    ::Arena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const Allocator<T>& lhs, const Allocator<U>& rhs) noexcept {
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const Allocator<T>& lhs, const Allocator<U>& rhs) noexcept {
+    return lhs.arena() != rhs.arena();
+}
+
+} // namespace arena
+
+#endif // ARENA_HPP
@@ -0,0 +1,99 @@
+#ifndef ARENA_CONCURRENT_H
+#define ARENA_CONCURRENT_H
+
+#include <stddef.h>     // for size_t
+#include <stdbool.h>    // for bool
+#include <stdatomic.h>  // for _Atomic
+
+/**
+ * @brief A single memory block of a concurrent arena.
+ *
+ * @param prev   The block that was current before this one was installed.
+ * @param offset The number of bytes handed out from this block. Threads advance it atomically,
+ *               so it can overshoot `size` when the block runs full.
+ * @param size   The number of usable bytes in the block.
+ * @param start  A pointer to the first usable byte of the block.
+ */
+typedef struct ConcurrentArenaBlock {
+    struct ConcurrentArenaBlock* prev;  // Previously installed block
+    _Atomic size_t offset;              // Bytes handed out, may exceed size once the block is full
+    size_t size;                        // Usable bytes in the block
+    char* start;                        // First usable byte of the block
+} ConcurrentArenaBlock;
+
+/**
+ * @brief An arena that many threads can allocate from at the same time without locks.
+ *
+ * The bump pointer of the current block is advanced with an atomic fetch-add (or a CAS loop for
+ * over-aligned requests). When a block runs full, the thread that noticed it allocates a new block
+ * and installs it with a single compare-and-swap; the other threads keep allocating and simply pick
+ * up whichever block won. A thread only allocates a block if the full one is still current, so
+ * losing the race, which wastes a block, is limited to threads that grow at the same instant.
+ * Previously returned memory never moves.
+ *
+ * @param block The block allocations are currently served from.
+ * @param if_size_too_small_double_in_size Flag if set to true then every new block is twice as large as the previous one.
+ * @note
+ * - Only `concurrent_arena_allocate()` and `concurrent_arena_used()` are thread safe. `concurrent_arena_reset()`
+ *   and `concurrent_arena_free()` must not run concurrently with any other call on the same arena.
+ */
+typedef struct ConcurrentArena {
+    _Atomic(ConcurrentArenaBlock*) block;  // Current block
+    bool if_size_too_small_double_in_size;
+} ConcurrentArena;
+
+/**
+ * @brief Create a new concurrent arena with the given initial size.
+ *
+ * @param initial_size The size of the first block in bytes.
+ * @param if_size_too_small_double_in_size Flag if set to true then new blocks double in size,
+ *        otherwise they have the same size as the previous block (both at least large enough for the allocation).
+ *
+ * @return A pointer to the newly created ConcurrentArena structure, or `NULL` if the allocation failed.
+ */
+ConcurrentArena* concurrent_arena_new(size_t initial_size, bool if_size_too_small_double_in_size);
+
+/**
+ * @brief Allocate zeroed, aligned memory from the arena. Safe to call from many threads at once.
+ *
+ * @param arena     Pointer to the ConcurrentArena structure from which to allocate memory.
+ * @param size      The desired size of the memory block in bytes.
+ * @param alignment The desired alignment of the memory block (must be a power of two).
+ *
+ * @return A pointer to the newly allocated memory block, or `NULL` if a new block could not be allocated.
+ *
+ * @note
+ * - Requests with an alignment of at most `_Alignof(max_align_t)` take the fetch-add path, larger
+ *   alignments retry with a compare-and-swap until they win.
+ */
+void* concurrent_arena_allocate(ConcurrentArena* arena, size_t size, size_t alignment);
+
+/**
+ * @brief Reset the arena, keeping only its most recent (and largest) block.
+ *
+ * All older blocks are freed. Must not be called while other threads use the arena.
+ *
+ * @param arena Pointer to the ConcurrentArena structure to be reset.
+ */
+void concurrent_arena_reset(ConcurrentArena* arena);
+
+/**
+ * @brief Frees all blocks of the arena and the ConcurrentArena structure itself.
+ *
+ * Must not be called while other threads use the arena.
+ *
+ * @param arena Pointer to the ConcurrentArena structure to be freed.
+ */
+void concurrent_arena_free(ConcurrentArena* arena);
+
+/**
+ * @brief Get the number of bytes handed out by the arena across all blocks, including alignment padding.
+ *
+ * While other threads allocate the result is only a snapshot.
+ *
+ * @param arena Pointer to the ConcurrentArena structure.
+ * @return The used space in the arena (in bytes).
+ */
+size_t concurrent_arena_used(ConcurrentArena* arena);
+
+#endif // ARENA_CONCURRENT_H
@@ -0,0 +1,103 @@
+#ifndef ARENA_FRAME_H
+#define ARENA_FRAME_H
+
+#include "arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A ring of arenas for pipelines that keep several frames in flight.
+ *
+ * With `frame_count` stages in flight, data allocated in frame k must survive until frame
+ * k + frame_count - 1 has finished, which a single arena reset once per frame cannot express.
+ * The frame arena owns one `Arena` per frame in flight and `frame_arena_advance()` rotates to the
+ * next one, resetting only the arena of the oldest frame, whose data is guaranteed to be dead.
+ * Resetting keeps every block of an arena, so in steady state no frame allocates from the system.
+ *
+ * @param arenas      One arena per frame in flight.
+ * @param frame_count The number of arenas in the ring.
+ * @param index       The index of the arena the current frame allocates from.
+ * @param frame       The number of the current frame, starting at 0.
+ */
+typedef struct FrameArena {
+    Arena** arenas;      // One arena per frame in flight
+    size_t frame_count;  // Number of arenas in the ring
+    size_t index;        // Arena of the current frame
+    size_t frame;        // Number of the current frame
+} FrameArena;
+
+/**
+ * @brief Create a frame arena with one arena per frame in flight.
+ *
+ * @param frame_count  The number of frames in flight (at least 1).
+ * @param initial_size The initial size of every arena in bytes.
+ * @param if_size_too_small_double_in_size Passed on to `arena_new()` for every arena.
+ *
+ * @return A pointer to the newly created FrameArena structure, or `NULL` if the allocation failed.
+ *
+ * @example
+ * FrameArena* frames = frame_arena_new(3, 1 << 20, true);  // Three pipeline stages in flight
+ * while (running) {
+ *     Arena* frame = frame_arena_advance(frames);
+ *     DrawList* list = arena_allocate(frame, sizeof(DrawList), alignof(DrawList));
+ *     submit(list);  // Consumed by the following stages, valid for two more frames
+ * }
+ * frame_arena_free(frames);
+ */
+FrameArena* frame_arena_new(size_t frame_count, size_t initial_size, bool if_size_too_small_double_in_size);
+
+/**
+ * @brief Get the arena the current frame allocates from.
+ *
+ * @param frames Pointer to the FrameArena structure.
+ * @return The arena of the current frame.
+ */
+static inline Arena* frame_arena_current(const FrameArena* frames) {
+    return frames->arenas[frames->index];
+}
+
+/**
+ * @brief Get the arena of an earlier frame that is still in flight.
+ *
+ * @param frames     Pointer to the FrameArena structure.
+ * @param frames_ago How many frames back, from 0 (the current frame) to `frame_count - 1`.
+ * @return The arena of that frame.
+ */
+static inline Arena* frame_arena_previous(const FrameArena* frames, size_t frames_ago) {
+    return frames->arenas[(frames->index + frames->frame_count - frames_ago) % frames->frame_count];
+}
+
+/**
+ * @brief Start the next frame.
+ *
+ * Rotates to the arena of the oldest frame and resets it. Call it once the oldest frame in flight
+ * has been fully consumed; the arenas of the other frames are left untouched.
+ *
+ * @param frames Pointer to the FrameArena structure.
+ * @return The reset arena the new frame allocates from.
+ */
+Arena* frame_arena_advance(FrameArena* frames);
+
+/**
+ * @brief Allocate zeroed, aligned memory that lives for `frame_count` frames.
+ *
+ * Equivalent to `arena_allocate(frame_arena_current(frames), size, alignment)`.
+ */
+static inline void* frame_arena_allocate(FrameArena* frames, size_t size, size_t alignment) {
+    return arena_allocate(frame_arena_current(frames), size, alignment);
+}
+
+/**
+ * @brief Free every arena of the ring and the FrameArena structure itself.
+ *
+ * @param frames Pointer to the FrameArena structure to be freed.
+ */
+void frame_arena_free(FrameArena* frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_FRAME_H
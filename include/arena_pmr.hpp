@@ -0,0 +1,62 @@
+#ifndef ARENA_PMR_HPP
+#define ARENA_PMR_HPP
+
+#include "arena.hpp"
+
+#include <cstddef>          // for std::size_t
+#include <memory_resource>  // for std::pmr::memory_resource
+#include <new>              // for std::bad_alloc
+
+namespace arena {
+
+/**
+ * @brief A `std::pmr::memory_resource` that allocates from an `Arena`.
+ *
+ * Lets standard containers such as `std::pmr::vector`, `std::pmr::string` or
+ * `std::pmr::unordered_map` live in an arena without changing their code. The resource does not
+ * own the arena; it must outlive every container that uses the resource.
+ *
+ * @note
+ * - Memory is not zeroed, containers construct their elements themselves.
+ * - Deallocation is a no-op, except when the block being released is the most recent allocation.
+ *   Then the arena's position is rolled back, so a vector that reallocates at the top of the
+ *   arena gives its old buffer back.
+ *
+ * @example
+ * arena::Arena requestArena(64 * 1024);
+ * arena::MemoryResource resource(requestArena);
+ * std::pmr::vector<int> ids(&resource);
+ * std::pmr::unordered_map<std::pmr::string, int> counts(&resource);
+ */
+class MemoryResource : public std::pmr::memory_resource {
+public:
+    explicit MemoryResource(::Arena* arena) noexcept : arena_(arena) {}
+    explicit MemoryResource(Arena& arena) noexcept : arena_(arena.get()) {}
+
+    // The arena this resource allocates from.
+    ::Arena* arena() const noexcept { return arena_; }
+
+protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        void* ptr = arena_allocate_ex(arena_, bytes, alignment, ARENA_ALLOC_NO_ZERO);
+        if (!ptr) { throw std::bad_alloc(); }
+        return ptr;
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t /*alignment*/) override {
+        // Roll back the most recent allocation, everything else is released with the arena
+        arena_try_pop(arena_, ptr, bytes);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        const MemoryResource* resource = dynamic_cast<const MemoryResource*>(&other);
+        return resource && resource->arena_ == arena_;
+    }
+
+private:
+    ::Arena* arena_;
+};
+
+} // namespace arena
+
+#endif // ARENA_PMR_HPP
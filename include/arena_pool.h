@@ -0,0 +1,92 @@
+#ifndef ARENA_POOL_H
+#define ARENA_POOL_H
+
+#include "arena.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A pool of fixed-size slots carved out of an `Arena`.
+ *
+ * Serves objects that all have the same size and are freed individually, which `arena_reset()`
+ * alone cannot express. Freed slots are kept in an intrusive free list threaded through the slots
+ * themselves, so `arena_pool_alloc()` and `arena_pool_free()` are O(1) and need no per-object header.
+ * New slots are taken from cache line aligned, page sized batches allocated with `arena_allocate_ex()`,
+ * so refilling the pool is amortized over many allocations.
+ *
+ * @param arena          The arena the batches are allocated from. The pool does not own it.
+ * @param free_list      The most recently freed slot; every free slot stores a pointer to the next one.
+ * @param batch_current  The next never used slot of the current batch.
+ * @param batch_end      One past the end of the current batch.
+ * @param slot_size      The size of a slot, at least the requested size and large enough to hold a pointer.
+ * @param slot_alignment The alignment of every slot.
+ * @param batch_size     The number of bytes allocated from the arena on every refill.
+ * @param generation     The arena generation the pool's slots belong to.
+ * @param slots_in_use   The number of slots currently handed out.
+ * @param slots_carved   The number of slots carved out of batches so far, free or in use.
+ * @note
+ * - The pool is released wholesale with its arena: after `arena_reset()` the pool starts over with
+ *   fresh batches and slots from before the reset must not be freed anymore. After `arena_free()`
+ *   the pool must not be used anymore.
+ * - Rewinding the arena with `arena_rewind()` to a mark taken before a batch was allocated is not
+ *   detected and must be avoided while the pool is in use.
+ */
+typedef struct ArenaPool {
+    Arena* arena;           // Arena the batches come from
+    void* free_list;        // Intrusive list of freed slots
+    char* batch_current;    // Next never used slot of the current batch
+    char* batch_end;        // End of the current batch
+    size_t slot_size;       // Size of a slot in bytes
+    size_t slot_alignment;  // Alignment of a slot
+    size_t batch_size;      // Bytes allocated from the arena per refill
+    size_t generation;      // Arena generation the slots belong to
+    size_t slots_in_use;    // Slots currently handed out
+    size_t slots_carved;    // Slots carved out of batches so far
+} ArenaPool;
+
+/**
+ * @brief Initialize a pool of fixed-size slots on top of an arena.
+ *
+ * @param pool           Pointer to the ArenaPool structure to initialize.
+ * @param arena          The arena to allocate batches from.
+ * @param slot_size      The size of every object in bytes.
+ * @param slot_alignment The alignment of every object (must be a power of two).
+ *
+ * @note No memory is allocated until the first `arena_pool_alloc()`.
+ *
+ * @example
+ * ArenaPool nodes;
+ * arena_pool_init(&nodes, myArena, sizeof(Node), alignof(Node));
+ * Node* node = arena_pool_alloc(&nodes);
+ * arena_pool_free(&nodes, node);
+ */
+void arena_pool_init(ArenaPool* pool, Arena* arena, size_t slot_size, size_t slot_alignment);
+
+/**
+ * @brief Take a slot from the pool.
+ *
+ * Reuses the most recently freed slot if there is one, otherwise carves a new slot out of the
+ * current batch and allocates a new batch from the arena when that is exhausted.
+ *
+ * @param pool Pointer to the ArenaPool structure.
+ * @return A pointer to a slot of `slot_size` bytes, or `NULL` if the arena could not grow.
+ *
+ * @note Unlike `arena_allocate()`, the slot is not zeroed.
+ */
+void* arena_pool_alloc(ArenaPool* pool);
+
+/**
+ * @brief Give a slot back to the pool.
+ *
+ * @param pool Pointer to the ArenaPool structure.
+ * @param ptr  A slot returned by `arena_pool_alloc()` on the same pool, or `NULL`.
+ */
+void arena_pool_free(ArenaPool* pool, void* ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_POOL_H
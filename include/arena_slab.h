@@ -0,0 +1,121 @@
+#ifndef ARENA_SLAB_H
+#define ARENA_SLAB_H
+
+#include "arena_pool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ARENA_SLAB_CLASS_COUNT 28    // Number of size classes
+#define ARENA_SLAB_MAX_SIZE    4096  // Largest size served from a size class
+#define ARENA_SLAB_ALIGNMENT   16    // Alignment of every object served from a size class
+
+/**
+ * @brief A general small-object allocator made of size classes carved out of an `Arena`.
+ *
+ * Requests from 1 B up to `ARENA_SLAB_MAX_SIZE` are rounded up to one of `ARENA_SLAB_CLASS_COUNT`
+ * size classes (16 B steps up to 128 B, then four classes per power of two). Every class is an
+ * `ArenaPool` with its own free list, so objects can be freed and reused individually while still
+ * being packed next to each other in the arena. Long lived services that cannot periodically call
+ * `arena_reset()` get arena-like locality with near-zero per-allocation overhead.
+ *
+ * @param arena            The arena every class allocates its slabs from. The slab does not own it.
+ * @param classes          One pool per size class.
+ * @param bytes_requested  Per class, the sum of the sizes requested by the objects currently in use.
+ * @param large_allocations Number of requests above `ARENA_SLAB_MAX_SIZE`, served directly by the arena.
+ * @param large_bytes      Bytes of those requests. They are only released with the arena.
+ * @param generation       The arena generation the statistics belong to.
+ * @note
+ * - Like `ArenaPool`, the slab is released wholesale by `arena_reset()` and must not be used after `arena_free()`.
+ * - Objects are aligned to `ARENA_SLAB_ALIGNMENT` bytes and are not zeroed.
+ */
+typedef struct ArenaSlab {
+    Arena* arena;                                   // Arena the slabs come from
+    ArenaPool classes[ARENA_SLAB_CLASS_COUNT];      // One pool per size class
+    size_t bytes_requested[ARENA_SLAB_CLASS_COUNT]; // Requested bytes of live objects per class
+    size_t large_allocations;                       // Requests above ARENA_SLAB_MAX_SIZE
+    size_t large_bytes;                             // Bytes of those requests
+    size_t generation;                              // Arena generation the statistics belong to
+} ArenaSlab;
+
+/**
+ * @brief Occupancy and fragmentation of one size class, filled by `arena_slab_class_stats()`.
+ *
+ * @param slot_size       The size every object of the class occupies.
+ * @param slots_in_use    The number of objects currently allocated.
+ * @param slots_carved    The number of slots carved out of slabs so far.
+ * @param bytes_requested The sum of the sizes requested by the objects currently allocated.
+ * @param occupancy       `slots_in_use / slots_carved`, 1.0 when nothing has been carved yet.
+ * @param fragmentation   The fraction of carved bytes not holding requested data, covering both
+ *                        free slots and the rounding of requests up to `slot_size` (0.0 to 1.0).
+ */
+typedef struct ArenaSlabClassStats {
+    size_t slot_size;        // Size of every object in the class
+    size_t slots_in_use;     // Objects currently allocated
+    size_t slots_carved;     // Slots carved so far
+    size_t bytes_requested;  // Requested bytes of the objects currently allocated
+    float occupancy;         // slots_in_use / slots_carved
+    float fragmentation;     // Carved bytes not holding requested data
+} ArenaSlabClassStats;
+
+/**
+ * @brief Initialize a slab allocator on top of an arena.
+ *
+ * @param slab  Pointer to the ArenaSlab structure to initialize.
+ * @param arena The arena to allocate slabs from.
+ *
+ * @example
+ * ArenaSlab objects;
+ * arena_slab_init(&objects, myArena);
+ * Message* message = arena_slab_alloc(&objects, sizeof(Message) + payload_size);
+ * arena_slab_free(&objects, message, sizeof(Message) + payload_size);
+ */
+void arena_slab_init(ArenaSlab* slab, Arena* arena);
+
+/**
+ * @brief Allocate an object of the given size.
+ *
+ * @param slab Pointer to the ArenaSlab structure.
+ * @param size The size of the object in bytes.
+ *
+ * @return A pointer aligned to `ARENA_SLAB_ALIGNMENT`, or `NULL` if the arena could not grow.
+ *
+ * @note Requests above `ARENA_SLAB_MAX_SIZE` are allocated from the arena directly; freeing them is a no-op.
+ */
+void* arena_slab_alloc(ArenaSlab* slab, size_t size);
+
+/**
+ * @brief Free an object allocated with `arena_slab_alloc()`.
+ *
+ * @param slab Pointer to the ArenaSlab structure.
+ * @param ptr  The object to free, or `NULL`.
+ * @param size The size that was passed to `arena_slab_alloc()`. It selects the size class, so
+ *             objects need no header.
+ */
+void arena_slab_free(ArenaSlab* slab, void* ptr, size_t size);
+
+/**
+ * @brief Get the occupancy and fragmentation of one size class.
+ *
+ * @param slab        Pointer to the ArenaSlab structure.
+ * @param class_index The index of the size class, from 0 to `ARENA_SLAB_CLASS_COUNT - 1`.
+ * @return The statistics of the class.
+ */
+ArenaSlabClassStats arena_slab_class_stats(const ArenaSlab* slab, size_t class_index);
+
+/**
+ * @brief Print per class statistics of the slab allocator.
+ *
+ * Prints the statistics of the underlying arena with `arena_print_stats()`, followed by one line
+ * per size class that has been used, showing its occupancy and fragmentation.
+ *
+ * @param slab Pointer to the ArenaSlab structure.
+ */
+void arena_slab_print_stats(const ArenaSlab* slab);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ARENA_SLAB_H
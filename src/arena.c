@@ -1,88 +1,1044 @@
+// Exposes mmap flags such as MAP_ANONYMOUS when compiling with a strict -std=c11
+#define _DEFAULT_SOURCE
+
 #include "arena.h"
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>  // For memset
 #include <stdio.h>
+#include <time.h>    // For timing growth in the statistics
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ARENA_HAS_MMAP 1
+#include <sys/mman.h>
+#include <unistd.h>
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+// glibc only exposes the shift, the page size encoding is part of the kernel ABI (log2 of the size)
+#if !defined(MAP_HUGE_2MB) && defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#define ARENA_HAS_PTHREADS 1
+#include <pthread.h> // For the background zeroing thread
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h> // For non-temporal stores when zeroing at reset
+#endif
+
+// Block headers are padded so the usable memory of a block starts at the same
+// alignment malloc guarantees.
+#define ARENA_BLOCK_HEADER_SIZE \
+    ((sizeof(ArenaBlock) + _Alignof(max_align_t) - 1) & ~(_Alignof(max_align_t) - 1))
+
+// Size and alignment of the blocks of huge page backed arenas.
+#define ARENA_HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+static size_t arena_page_size(void) {
+#ifdef ARENA_HAS_MMAP
+    static size_t page_size = 0;
+    if (page_size == 0) { page_size = (size_t)sysconf(_SC_PAGESIZE); }
+    return page_size;
+#else
+    return 4096;
+#endif
+}
+
+// Rounds `value` up to a multiple of `granularity`. The caller makes sure this cannot overflow.
+static size_t arena_round_up(size_t value, size_t granularity) {
+    return (value + granularity - 1) / granularity * granularity;
+}
+
+// Fills in the header of a block whose memory begins at `memory` and ends at `end`. Only memory
+// that is known to be `zeroed`, such as a fresh mapping, is handed out without clearing it.
+static ArenaBlock* arena_block_init(char* memory, char* end, ArenaBacking backing, bool zeroed) {
+    ArenaBlock* block = (ArenaBlock*)memory;
+    block->prev = NULL;
+    block->next = NULL;
+    block->start = memory + ARENA_BLOCK_HEADER_SIZE;
+    block->end = end;
+    block->zero = zeroed ? block->start : end;
+    block->discarded = NULL;
+    block->discarded_end = NULL;
+    block->backing = backing;
+    return block;
+}
+
+#ifdef ARENA_HAS_MMAP
+// Maps `mapping_size` bytes aligned to ARENA_HUGE_PAGE_SIZE and asks the kernel to back them with
+// transparent huge pages. Falls back to a plain mapping when the advice is not supported.
+static ArenaBlock* arena_block_map_transparent(size_t mapping_size) {
+    size_t page_size = arena_page_size();
+    if (mapping_size > SIZE_MAX - ARENA_HUGE_PAGE_SIZE) { return NULL; }
+
+    // Over-map so an aligned region fits, then unmap the unaligned head and tail
+    size_t over_size = mapping_size + ARENA_HUGE_PAGE_SIZE - page_size;
+    char* memory = mmap(NULL, over_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) { return NULL; }
+
+    char* aligned = (char*)(((uintptr_t)memory + ARENA_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(ARENA_HUGE_PAGE_SIZE - 1));
+    if (aligned > memory) { munmap(memory, aligned - memory); }
+    char* tail = aligned + mapping_size;
+    if (tail < memory + over_size) { munmap(tail, memory + over_size - tail); }
+
+    ArenaBacking backing = ARENA_BACKING_MMAP;
+#ifdef MADV_HUGEPAGE
+    if (madvise(aligned, mapping_size, MADV_HUGEPAGE) == 0) { backing = ARENA_BACKING_TRANSPARENT; }
+#endif
+    return arena_block_init(aligned, tail, backing, true);
+}
+
+// Maps a block of at least `size` usable bytes rounded up to the huge page size. Explicit huge pages
+// fall back to transparent huge pages when none are reserved.
+static ArenaBlock* arena_block_map_huge(ArenaBacking backing, size_t size) {
+    if (size > SIZE_MAX - ARENA_BLOCK_HEADER_SIZE - ARENA_HUGE_PAGE_SIZE) { return NULL; }
+    size_t mapping_size = arena_round_up(ARENA_BLOCK_HEADER_SIZE + size, ARENA_HUGE_PAGE_SIZE);
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_2MB)
+    // Without the size flag the kernel uses the default huge page size, which may be 1 GiB
+    if (backing == ARENA_BACKING_HUGETLB) {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB;
+        char* memory = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+        if (memory != MAP_FAILED) {
+            return arena_block_init(memory, memory + mapping_size, ARENA_BACKING_HUGETLB, true);
+        }
+    }
+#else
+    (void)backing;
+#endif
+    return arena_block_map_transparent(mapping_size);
+}
+
+// Blocks of at least this size are mapped directly. Fresh mappings are known to be zero, while
+// malloc may serve even large blocks from recycled heap memory that would have to be cleared.
+#define ARENA_BLOCK_MAP_THRESHOLD ((size_t)256 << 10)
+
+// Maps a block of at least `size` usable bytes rounded up to the page size.
+static ArenaBlock* arena_block_map(size_t size) {
+    size_t page_size = arena_page_size();
+    if (size > SIZE_MAX - ARENA_BLOCK_HEADER_SIZE - page_size) { return NULL; }
+    size_t mapping_size = arena_round_up(ARENA_BLOCK_HEADER_SIZE + size, page_size);
+
+    char* memory = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) { return NULL; }
+    return arena_block_init(memory, memory + mapping_size, ARENA_BACKING_MMAP, true);
+}
+#endif
+
+// Allocates a block of at least `size` usable bytes with the backing the arena asked for.
+static ArenaBlock* arena_block_new(const Arena* arena, size_t size) {
+#ifdef ARENA_HAS_MMAP
+    if (arena->backing == ARENA_BACKING_HUGETLB || arena->backing == ARENA_BACKING_TRANSPARENT) {
+        return arena_block_map_huge(arena->backing, size);
+    }
+    if (size >= ARENA_BLOCK_MAP_THRESHOLD) {
+        ArenaBlock* block = arena_block_map(size);
+        if (block) { return block; }
+    }
+#endif
+
+    if (size > SIZE_MAX - ARENA_BLOCK_HEADER_SIZE) { return NULL; }
+
+    // Heap memory may be recycled, so it is treated as dirty and cleared as it is handed out
+    char* memory = malloc(ARENA_BLOCK_HEADER_SIZE + size);
+    if (!memory) { return NULL; }
+
+    return arena_block_init(memory, memory + ARENA_BLOCK_HEADER_SIZE + size, ARENA_BACKING_MALLOC, false);
+}
+
+static void arena_block_free(ArenaBlock* block) {
+#ifdef ARENA_HAS_MMAP
+    if (block->backing != ARENA_BACKING_MALLOC) {
+        munmap(block, block->end - (char*)block);
+        return;
+    }
+#endif
+    free(block);
+}
+
+// Starts timing an operation that grows the arena, 0 when statistics are compiled out.
+static uint64_t arena_stats_clock(void) {
+#if ARENA_STATS
+    struct timespec now;
+#ifdef ARENA_HAS_MMAP
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#else
+    timespec_get(&now, TIME_UTC);
+#endif
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+// Counts a successful growth of the arena that started at `started` (from arena_stats_clock).
+static void arena_stats_record_growth(Arena* arena, uint64_t started) {
+#if ARENA_STATS
+    arena->counters.growths++;
+    arena->counters.grow_nanoseconds += arena_stats_clock() - started;
+#else
+    (void)arena;
+    (void)started;
+#endif
+}
+
+// An allocation above the large object threshold, placed in its own mapping and
+// linked into the arena's side list (most recent first).
+typedef struct ArenaLargeObject {
+    struct ArenaLargeObject* next;  // Previously allocated large object
+    size_t mapping_size;            // Size of the whole mapping, header included
+    size_t size;                    // Requested size
+} ArenaLargeObject;
+
+// Allocates a large object in a dedicated mapping. Fresh anonymous mappings are already zeroed.
+static void* arena_allocate_large(Arena* arena, size_t size, size_t alignment, unsigned int flags) {
+    if (flags & ARENA_ALLOC_NO_GROW) { return NULL; }
+
+    size_t header_size = sizeof(ArenaLargeObject);
+    if (size > SIZE_MAX - header_size - alignment) { return NULL; }
+    size_t mapping_size = header_size + alignment - 1 + size;
+
+    ArenaLargeObject* object;
+    bool zeroed = false;
+#ifdef ARENA_HAS_MMAP
+    mapping_size = arena_round_up(mapping_size, arena_page_size());
+    void* memory = mmap(NULL, mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) { return NULL; }
+    object = memory;
+    zeroed = true;
+#else
+    object = malloc(mapping_size);
+    if (!object) { return NULL; }
+#endif
+
+    object->next = arena->large_objects;
+    object->mapping_size = mapping_size;
+    object->size = size;
+    arena->large_objects = object;
+    arena->large_count++;
+    arena->large_bytes += size;
+#if ARENA_STATS
+    arena->counters.allocations++;
+    arena->counters.bytes_requested += size;
+#endif
+
+    char* ptr = (char*)object + header_size;
+    ptr += (size_t)(-(uintptr_t)ptr) & (alignment - 1);
+    if (!zeroed && !(flags & ARENA_ALLOC_NO_ZERO)) { memset(ptr, 0, size); }
+    return ptr;
+}
+
+// Releases the large objects allocated after `keep`, the most recent one kept (NULL releases all).
+static void arena_release_large(Arena* arena, struct ArenaLargeObject* keep) {
+    while (arena->large_objects && arena->large_objects != keep) {
+        ArenaLargeObject* object = arena->large_objects;
+        arena->large_objects = object->next;
+        arena->large_count--;
+        arena->large_bytes -= object->size;
+#ifdef ARENA_HAS_MMAP
+        munmap(object, object->mapping_size);
+#else
+        free(object);
+#endif
+    }
+}
+
+void arena_set_large_threshold(Arena* arena, size_t threshold) {
+    arena->large_threshold = threshold ? threshold : SIZE_MAX;
+}
+
+// Links `block` into the chain directly after the current block.
+static void arena_insert_block(Arena* arena, ArenaBlock* block) {
+    block->prev = arena->block;
+    block->next = arena->block->next;
+    if (block->next) { block->next->prev = block; }
+    arena->block->next = block;
+    arena->size += block->end - block->start;
+}
+
+// Saves the known-zero watermark of the current block before the arena moves on to another one.
+static void arena_save_zero(Arena* arena) {
+    arena_track_zero(arena);
+    arena->block->zero = arena->zero;
+}
+
+// Records that the dirty memory from `begin` on was handed back lazily: the pages may keep their
+// contents, so they stay dirty, but the watermark below `begin` no longer has to cover them.
+static void arena_block_discard_lazily(ArenaBlock* block, char* begin) {
+    // An earlier range starts at or above the watermark and is merged into the new one
+    char* end = block->zero;
+    if (block->discarded) {
+        if (block->discarded < begin) { begin = block->discarded; }
+        end = block->discarded_end;
+    }
+    if (end <= begin) { return; } // Nothing from `begin` on was handed out, the pages are still zero
+
+    block->discarded = begin;
+    block->discarded_end = end;
+    if (block->zero > begin) { block->zero = begin; }
+}
+
+// Records that the pages from `begin` to the end of the block were discarded with MADV_DONTNEED
+// and read back as zero.
+static void arena_block_discard(ArenaBlock* block, char* begin) {
+    if (block->discarded && block->discarded_end > begin) {
+        block->discarded_end = begin;
+        if (block->discarded >= begin) {
+            block->discarded = NULL;
+            block->discarded_end = NULL;
+        }
+    }
+    if (block->zero > begin) { block->zero = begin; }
+}
+
+// Loads the position of `block` into the arena. A discarded range clamps `end` so the fast path
+// never allocates into it with the low watermark.
+static void arena_load_block(Arena* arena, ArenaBlock* block) {
+    arena->block = block;
+    arena->start = block->start;
+    arena->end = block->discarded ? block->discarded : block->end;
+    arena->zero = block->zero;
+}
+
+// Lifts the clamp of a discarded range once the arena allocates past it, from then on the range is
+// below the watermark and zeroed on allocation.
+static void arena_lift_discarded(Arena* arena) {
+    ArenaBlock* block = arena->block;
+    if (ARENA_LIKELY(!block->discarded)) { return; }
+
+    if (block->discarded_end > arena->zero) { arena->zero = block->discarded_end; }
+    block->discarded = NULL;
+    block->discarded_end = NULL;
+    arena->end = block->end;
+}
+
+// Makes `block` the block allocations are served from.
+static void arena_enter_block(Arena* arena, ArenaBlock* block) {
+    arena_save_zero(arena);
+    arena->used_before_block += arena->current - arena->start;
+    arena_load_block(arena, block);
+    arena->current = block->start;
+}
+
+// Ranges below this are cleared with a plain memset. Streaming stores bypass the cache, which only
+// pays off once the range is large enough to evict data that is still needed.
+#define ARENA_ZERO_STREAM_THRESHOLD ((size_t)256 << 10)
+
+// Zeroes [begin, end) with non-temporal stores where available, memory about to be refilled is not
+// worth keeping in the cache.
+static void arena_zero_range(char* begin, char* end) {
+#if defined(__SSE2__)
+    if ((size_t)(end - begin) >= ARENA_ZERO_STREAM_THRESHOLD) {
+        char* lines = (char*)(((uintptr_t)begin + 63) & ~(uintptr_t)63);
+        char* lines_end = (char*)((uintptr_t)end & ~(uintptr_t)63);
+        __m128i zero = _mm_setzero_si128();
+        memset(begin, 0, lines - begin);
+        for (char* line = lines; line < lines_end; line += 64) {
+            _mm_stream_si128((__m128i*)line, zero);
+            _mm_stream_si128((__m128i*)(line + 16), zero);
+            _mm_stream_si128((__m128i*)(line + 32), zero);
+            _mm_stream_si128((__m128i*)(line + 48), zero);
+        }
+        memset(lines_end, 0, end - lines_end);
+        _mm_sfence(); // Streaming stores are weakly ordered, publish them before the memory is handed out
+        return;
+    }
+#endif
+    memset(begin, 0, end - begin);
+}
+
+// Zeroes every block from `block` on up to its known-zero watermark and lowers the watermark to the start.
+// Lazily discarded pages are left alone, writing them would fault them back in and undo the trim.
+static void arena_zero_blocks(ArenaBlock* block) {
+    for (; block; block = block->next) {
+        // A virtual arena's watermark can lie above `end` after a lazy trim decommitted the pages
+        arena_block_discard_lazily(block, block->end);
+        arena_zero_range(block->start, block->zero);
+        block->zero = block->start;
+    }
+}
+
+#ifdef ARENA_HAS_PTHREADS
+// Thread zeroing the blocks of an ARENA_ZERO_ON_RESET_BACKGROUND arena after a reset.
+typedef struct ArenaZeroWorker {
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;   // Signals new work to the thread and its completion to the arena
+    ArenaBlock* blocks;    // Chain to zero, NULL while idle
+    bool stop;
+} ArenaZeroWorker;
 
+static void* arena_zero_worker_main(void* data) {
+    ArenaZeroWorker* worker = data;
+    pthread_mutex_lock(&worker->mutex);
+    for (;;) {
+        while (!worker->blocks && !worker->stop) { pthread_cond_wait(&worker->cond, &worker->mutex); }
+        if (!worker->blocks) { break; }
+
+        ArenaBlock* blocks = worker->blocks;
+        pthread_mutex_unlock(&worker->mutex);
+        arena_zero_blocks(blocks);
+        pthread_mutex_lock(&worker->mutex);
+        worker->blocks = NULL;
+        pthread_cond_broadcast(&worker->cond);
+    }
+    pthread_mutex_unlock(&worker->mutex);
+    return NULL;
+}
+
+static ArenaZeroWorker* arena_zero_worker_new(void) {
+    ArenaZeroWorker* worker = malloc(sizeof(ArenaZeroWorker));
+    if (!worker) { return NULL; }
+
+    worker->blocks = NULL;
+    worker->stop = false;
+    pthread_mutex_init(&worker->mutex, NULL);
+    pthread_cond_init(&worker->cond, NULL);
+    if (pthread_create(&worker->thread, NULL, arena_zero_worker_main, worker) != 0) {
+        pthread_cond_destroy(&worker->cond);
+        pthread_mutex_destroy(&worker->mutex);
+        free(worker);
+        return NULL;
+    }
+    return worker;
+}
+
+static void arena_zero_worker_free(ArenaZeroWorker* worker) {
+    pthread_mutex_lock(&worker->mutex);
+    worker->stop = true;
+    pthread_cond_broadcast(&worker->cond);
+    pthread_mutex_unlock(&worker->mutex);
+    pthread_join(worker->thread, NULL);
+    pthread_cond_destroy(&worker->cond);
+    pthread_mutex_destroy(&worker->mutex);
+    free(worker);
+}
+#endif
+
+// Waits for background zeroing to finish and lifts the clamp of `end`. Called before anything that
+// touches the blocks.
+static void arena_zero_wait(Arena* arena) {
+#ifdef ARENA_HAS_PTHREADS
+    if (ARENA_LIKELY(!arena->zeroing)) { return; }
+
+    ArenaZeroWorker* worker = arena->zero_worker;
+    pthread_mutex_lock(&worker->mutex);
+    while (worker->blocks) { pthread_cond_wait(&worker->cond, &worker->mutex); }
+    pthread_mutex_unlock(&worker->mutex);
+    arena->zeroing = false;
+    arena_load_block(arena, arena->block);
+#else
+    (void)arena;
+#endif
+}
+
+// Zeroes the memory a reset released according to the zero mode, the arena is on its first block.
+static void arena_zero_released(Arena* arena) {
+    if (arena->zero_mode == ARENA_ZERO_ON_ALLOCATE || arena->double_ended) { return; }
+
+#ifdef ARENA_HAS_PTHREADS
+    if (arena->zero_worker) {
+        // Clamping `end` sends every allocation to the slow path, which waits for the thread
+        ArenaZeroWorker* worker = arena->zero_worker;
+        pthread_mutex_lock(&worker->mutex);
+        worker->blocks = arena->first;
+        pthread_cond_broadcast(&worker->cond);
+        pthread_mutex_unlock(&worker->mutex);
+        arena->zeroing = true;
+        arena->end = arena->start;
+        return;
+    }
+#endif
+    arena_zero_blocks(arena->first);
+    arena->zero = arena->block->zero;
+}
+
+ArenaError arena_set_zero_mode(Arena* arena, ArenaZeroMode mode) {
+    arena_zero_wait(arena);
+#ifdef ARENA_HAS_PTHREADS
+    bool background = mode == ARENA_ZERO_ON_RESET_BACKGROUND && !arena->double_ended;
+    if (background && !arena->zero_worker) {
+        arena->zero_worker = arena_zero_worker_new();
+        if (!arena->zero_worker) { return ARENA_ERROR_ALLOCATION_FAILED; }
+    } else if (!background && arena->zero_worker) {
+        arena_zero_worker_free(arena->zero_worker);
+        arena->zero_worker = NULL;
+    }
+#endif
+    arena->zero_mode = mode;
+    return ARENA_SUCCESS;
+}
+
+// Initializes every field of a fresh arena whose only block is `block`, with the defaults of an
+// arena that does not double its blocks. Constructors adjust what differs afterwards.
+static void arena_init_fields(Arena* arena, ArenaBlock* block, ArenaBacking backing) {
+    arena->first = block;
+    arena->block = block;
+    arena->start = block->start;
+    arena->current = block->start;
+    arena->end = block->end;
+    arena->zero = block->zero;
+    arena->size = block->end - block->start;
+    arena->backing = backing;
+    arena->reserved = 0;
+    arena->commit_granularity = 0;
+    arena->generation = 0;
+    arena->used_before_block = 0;
+    arena->double_ended = false;
+    memset(&arena->counters, 0, sizeof(arena->counters));
+    arena->tags = NULL;
+    arena->tag_capacity = 0;
+    arena->tag_count = 0;
+    arena->growth = (ArenaGrowthPolicy){ ARENA_GROWTH_GEOMETRIC, 1.0, 0, 0, 0, NULL, NULL };
+    arena->large_objects = NULL;
+    arena->large_threshold = SIZE_MAX;
+    arena->retained = 0;
+    arena->large_count = 0;
+    arena->large_bytes = 0;
+    arena->zero_mode = ARENA_ZERO_ON_ALLOCATE;
+    arena->zero_worker = NULL;
+    arena->zeroing = false;
+}
+
+// Creates an arena whose first block has at least `initial_size` bytes with the given backing.
+static Arena* arena_new_with_backing(size_t initial_size, bool if_size_too_small_double_in_size, ArenaBacking backing) {
+    Arena* arena = malloc(sizeof(Arena));
+    if (!arena) { return NULL; }
+
+    arena->backing = backing;
+    ArenaBlock* block = arena_block_new(arena, initial_size);
+    if (!block) {
+        free(arena);
+        return NULL;
+    }
+
+    arena_init_fields(arena, block, backing);
+    arena->growth.factor = if_size_too_small_double_in_size ? 2.0 : 1.0;
+    return arena;
+}
 
 Arena* arena_new(size_t initial_size, bool if_size_too_small_double_in_size) {
+    return arena_new_with_backing(initial_size, if_size_too_small_double_in_size, ARENA_BACKING_MALLOC);
+}
+
+Arena* arena_new_huge(size_t initial_size, bool if_size_too_small_double_in_size, bool explicit_huge_pages) {
+    ArenaBacking backing = explicit_huge_pages ? ARENA_BACKING_HUGETLB : ARENA_BACKING_TRANSPARENT;
+    return arena_new_with_backing(initial_size, if_size_too_small_double_in_size, backing);
+}
+
+Arena* arena_new_virtual(size_t reserve_size, size_t commit_granularity) {
+#ifdef ARENA_HAS_MMAP
+    size_t page_size = arena_page_size();
+    if (commit_granularity > SIZE_MAX - page_size) { return NULL; }
+    commit_granularity = commit_granularity < page_size ? page_size : arena_round_up(commit_granularity, page_size);
+    if (reserve_size > SIZE_MAX - ARENA_BLOCK_HEADER_SIZE - page_size) { return NULL; }
+    size_t mapping_size = arena_round_up(reserve_size + ARENA_BLOCK_HEADER_SIZE, page_size);
+
     Arena* arena = malloc(sizeof(Arena));
     if (!arena) { return NULL; }
 
-    arena->start = malloc(initial_size);
-    if (!arena->start) { 
+    // Reserve the address range without backing it with memory
+    char* base = mmap(NULL, mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED) {
         free(arena);
         return NULL;
     }
 
-    arena->current = arena->start;
-    arena->size = initial_size;
-    arena->if_size_too_small_double_in_size = if_size_too_small_double_in_size;
+    // Commit the first chunk, it also holds the block header
+    size_t commit_size = commit_granularity < mapping_size ? commit_granularity : mapping_size;
+    if (mprotect(base, commit_size, PROT_READ | PROT_WRITE) != 0) {
+        munmap(base, mapping_size);
+        free(arena);
+        return NULL;
+    }
+
+    ArenaBlock* block = arena_block_init(base, base + commit_size, ARENA_BACKING_VIRTUAL, true);
+
+    arena_init_fields(arena, block, ARENA_BACKING_VIRTUAL);
+    arena->reserved = mapping_size - ARENA_BLOCK_HEADER_SIZE;
+    arena->commit_granularity = commit_granularity;
     return arena;
+#else
+    (void)reserve_size;
+    (void)commit_granularity;
+    return NULL;
+#endif
+}
+
+Arena* arena_new_double_ended(size_t size) {
+    Arena* arena = arena_new_with_backing(size, false, ARENA_BACKING_MALLOC);
+    if (!arena) { return NULL; }
+
+    // The high side hands out memory above the watermark, so nothing is treated as known-zero
+    arena->double_ended = true;
+    arena->zero = arena->end;
+    arena->block->zero = arena->end;
+    return arena;
+}
+
+// Commits enough of a virtual arena's reserved range for `needed` bytes past `current`.
+static bool arena_commit(Arena* arena, size_t needed) {
+#ifdef ARENA_HAS_MMAP
+    char* base = (char*)arena->first;
+    size_t limit = arena->growth.max_size && arena->growth.max_size < arena->reserved ? arena->growth.max_size : arena->reserved;
+    char* reserve_end = arena->start + limit;
+    if (needed > (size_t)(reserve_end - arena->current)) { return false; }
+
+    size_t commit_size = arena_round_up((size_t)(arena->current + needed - base), arena->commit_granularity);
+    char* commit_end = commit_size < (size_t)(reserve_end - base) ? base + commit_size : reserve_end;
+    if (commit_end <= arena->end) { return true; }
+
+    uint64_t started = arena_stats_clock();
+    if (mprotect(arena->end, commit_end - arena->end, PROT_READ | PROT_WRITE) != 0) { return false; }
+    arena_stats_record_growth(arena, started);
+
+    arena->size += commit_end - arena->end;
+    arena->end = commit_end;
+    arena->block->end = commit_end;
+    return true;
+#else
+    (void)arena;
+    (void)needed;
+    return false;
+#endif
 }
 
 void arena_free(Arena* arena) {
-    free(arena->start);
+    arena_zero_wait(arena);
+#ifdef ARENA_HAS_PTHREADS
+    if (arena->zero_worker) { arena_zero_worker_free(arena->zero_worker); }
+#endif
+    free(arena->tags);
+    arena_release_large(arena, NULL);
+
+#ifdef ARENA_HAS_MMAP
+    if (arena->backing == ARENA_BACKING_VIRTUAL) {
+        munmap(arena->first, arena->reserved + ARENA_BLOCK_HEADER_SIZE);
+        free(arena);
+        return;
+    }
+#endif
+
+    ArenaBlock* block = arena->first;
+    while (block) {
+        ArenaBlock* next = block->next;
+        arena_block_free(block);
+        block = next;
+    }
     free(arena);
 }
 
 ArenaError arena_grow(Arena* arena, size_t additional_size) {
-    size_t newSize = arena->size + additional_size;
-    char* newStart = realloc(arena->start, newSize);
-    if (!newStart) {
-        return ARENA_ERROR_REALLOCATION_FAILED; // Reallocation failed
+    if (arena->double_ended) {
+        return ARENA_ERROR_REALLOCATION_FAILED; // Both sides live in the single block
+    }
+    arena_zero_wait(arena);
+    arena_lift_discarded(arena);
+
+    if (arena->backing == ARENA_BACKING_VIRTUAL) {
+        size_t committed_free = arena->end - arena->current;
+        if (additional_size > SIZE_MAX - committed_free || !arena_commit(arena, committed_free + additional_size)) {
+            return ARENA_ERROR_REALLOCATION_FAILED; // Out of reserved address space or commit failed
+        }
+        return ARENA_SUCCESS;
     }
 
-    // Update arena state
-    size_t usedBytes = arena->current - arena->start; // Calculate used bytes before realloc
-    arena->start = newStart;
-    arena->current = arena->start + usedBytes; // Restore the current pointer
-    arena->size = newSize;
+    size_t max_size = arena->growth.max_size;
+    if (max_size && (arena->size >= max_size || additional_size > max_size - arena->size)) {
+        return ARENA_ERROR_REALLOCATION_FAILED; // Would exceed the cap of the growth policy
+    }
+
+    uint64_t started = arena_stats_clock();
+    ArenaBlock* block = arena_block_new(arena, additional_size);
+    if (!block) {
+        return ARENA_ERROR_REALLOCATION_FAILED; // Allocation of the new block failed
+    }
+    arena_stats_record_growth(arena, started);
+
+    arena_insert_block(arena, block);
     return ARENA_SUCCESS; // Growth successful
 }
 
-void* arena_allocate(Arena* arena, size_t size, size_t alignment) {
-    // Align the current position
-    size_t adjustment = alignment - ((size_t)arena->current % alignment);
-    if (adjustment == alignment) adjustment = 0;  // Already aligned
-
-    // Try to grow if not enough space
-    if (arena->current + adjustment + size > arena->start + arena->size) {
-        
-        if(arena->if_size_too_small_double_in_size == true){
-            if (!arena_grow(arena, arena->size * 2 + adjustment)) { 
-                return NULL; // Growth failed
-            } 
+void arena_set_growth_policy(Arena* arena, const ArenaGrowthPolicy* policy) {
+    arena->growth = *policy;
+    if (arena->growth.factor < 1.0) { arena->growth.factor = 1.0; }
+}
+
+// Size of the next block for a request of `needed` bytes according to the growth policy,
+// at least `needed`, or 0 if the policy refuses to grow or the arena would exceed its cap.
+static size_t arena_growth_block_size(const Arena* arena, size_t needed) {
+    const ArenaGrowthPolicy* policy = &arena->growth;
+    size_t previous = arena->block->end - arena->block->start;
+    size_t block_size;
+
+    switch (policy->kind) {
+        case ARENA_GROWTH_LINEAR:
+            block_size = previous <= SIZE_MAX - policy->step ? previous + policy->step : SIZE_MAX;
+            break;
+        case ARENA_GROWTH_CALLBACK:
+            block_size = policy->callback ? policy->callback(policy->user_data, previous, needed, arena->size) : 0;
+            if (block_size == 0) { return 0; }
+            break;
+        case ARENA_GROWTH_GEOMETRIC:
+        default: {
+            double scaled = (double)previous * policy->factor;
+            block_size = scaled < (double)(SIZE_MAX / 2) ? (size_t)scaled : SIZE_MAX / 2;
+            break;
         }
-        else {
-            if (!arena_grow(arena, arena->size + adjustment)) { 
-                return NULL; // Growth failed
+    }
+
+    if (policy->max_block_size && block_size > policy->max_block_size) { block_size = policy->max_block_size; }
+    if (block_size < needed) { block_size = needed; }
+
+    // The cap shrinks the block to the remaining budget, as long as the request still fits
+    if (policy->max_size) {
+        size_t budget = arena->size < policy->max_size ? policy->max_size - arena->size : 0;
+        if (needed > budget) { return 0; }
+        if (block_size > budget) { block_size = budget; }
+    }
+    return block_size;
+}
+
+// Moves the arena to a block that can hold `needed` bytes, recycling a spare block
+// if the next one is large enough and chaining a new one otherwise (if `allow_new_block`).
+static bool arena_next_block(Arena* arena, size_t needed, bool allow_new_block) {
+    ArenaBlock* next = arena->block->next;
+    if (next && (size_t)(next->end - next->start) >= needed) {
+        arena_enter_block(arena, next);
+        return true;
+    }
+    if (!allow_new_block) { return false; }
+
+    size_t block_size = arena_growth_block_size(arena, needed);
+    if (block_size == 0) { return false; }
+
+    uint64_t started = arena_stats_clock();
+    ArenaBlock* block = arena_block_new(arena, block_size);
+    if (!block) { return false; }
+    arena_stats_record_growth(arena, started);
+
+    arena_insert_block(arena, block);
+    arena_enter_block(arena, block);
+    return true;
+}
+
+void* arena_allocate_slow(Arena* arena, size_t size, size_t alignment, unsigned int flags) {
+    // Apply the alignment presets, double-ended arenas never leave their block
+    if (arena->double_ended) flags |= ARENA_ALLOC_NO_GROW;
+    if ((flags & ARENA_ALLOC_ALIGN_CACHE_LINE) && alignment < ARENA_CACHE_LINE_SIZE) alignment = ARENA_CACHE_LINE_SIZE;
+    if ((flags & ARENA_ALLOC_ALIGN_PAGE) && alignment < ARENA_PAGE_SIZE) alignment = ARENA_PAGE_SIZE;
+
+    // Large objects bypass the blocks, so they never inflate the next block size
+    if (size > arena->large_threshold) {
+        return arena_allocate_large(arena, size, alignment, flags);
+    }
+    arena_zero_wait(arena);
+    arena_lift_discarded(arena);
+
+    // Align the current position
+    size_t adjustment = (size_t)(-(uintptr_t)arena->current) & (alignment - 1);
+
+    // Move on to another block if there is not enough space left in this one
+    size_t free_bytes = arena->end - arena->current;
+    if (adjustment > free_bytes || size > free_bytes - adjustment) {
+        if (size > SIZE_MAX - alignment) { return NULL; }
+
+        if (arena->backing == ARENA_BACKING_VIRTUAL) {
+            // Virtual arenas never move on to another block, they commit more of their range instead.
+            if ((flags & ARENA_ALLOC_NO_GROW) || !arena_commit(arena, adjustment + size)) {
+                return NULL; // Growth not allowed or out of reserved address space
+            }
+        } else {
+            // A fresh block is only aligned to max_align_t, reserve room for the worst case adjustment.
+            if (!arena_next_block(arena, size + alignment - 1, !(flags & ARENA_ALLOC_NO_GROW))) {
+                return NULL; // Growth failed or not allowed
             }
-        }
 
+            adjustment = (size_t)(-(uintptr_t)arena->current) & (alignment - 1);
+            if (adjustment + size > (size_t)(arena->end - arena->current)) { arena_lift_discarded(arena); }
+        }
     }
 
     void* ptr = arena->current + adjustment;
     arena->current += adjustment + size;
+#if ARENA_STATS
+    arena->counters.allocations++;
+    arena->counters.bytes_requested += size;
+    arena->counters.bytes_padding += adjustment;
+#endif
 
-    memset(ptr, 0, size); // Initialize allocated memory to zero
+    if (!(flags & ARENA_ALLOC_NO_ZERO) && (char*)ptr < arena->zero) {
+        memset(ptr, 0, size); // Only memory below the known-zero watermark can be dirty
+    }
     return ptr;
 }
 
+void* arena_realloc(Arena* arena, void* ptr, size_t old_size, size_t new_size, size_t alignment) {
+    if (!ptr) { return arena_allocate(arena, new_size, alignment); }
+    arena_zero_wait(arena);
+    arena_lift_discarded(arena);
+
+    // The most recent allocation is resized by moving the allocation position
+    char* begin = ptr;
+    if (begin >= arena->start && begin + old_size == arena->current) {
+        if (new_size <= old_size) {
+            arena_track_high_water(arena);
+            arena_track_zero(arena);
+            arena->current = begin + new_size;
+            return ptr;
+        }
+
+        size_t available = arena->end - begin;
+        if (new_size > available && arena->backing == ARENA_BACKING_VIRTUAL) {
+            arena_commit(arena, new_size - old_size);
+            available = arena->end - begin;
+        }
+        if (new_size <= available) {
+            arena->current = begin + new_size;
+#if ARENA_STATS
+            arena->counters.bytes_requested += new_size - old_size;
+#endif
+            if (begin + old_size < arena->zero) { memset(begin + old_size, 0, new_size - old_size); }
+            return ptr;
+        }
+    } else if (new_size <= old_size) {
+        return ptr; // Shrinking in the middle of the arena leaves the tail as dead space
+    }
+
+    char* moved = arena_allocate_ex(arena, new_size, alignment, ARENA_ALLOC_NO_ZERO);
+    if (!moved) { return NULL; }
+
+    memcpy(moved, ptr, old_size);
+#if ARENA_STATS
+    arena->counters.bytes_copied += old_size;
+#endif
+    if (moved + old_size < arena->zero) { memset(moved + old_size, 0, new_size - old_size); }
+    return moved;
+}
+
+// Releases everything and makes the first block current again, without zeroing anything.
+static void arena_reset_blocks(Arena* arena) {
+    arena_zero_wait(arena);
+    arena_track_high_water(arena);
+    arena->generation++;
+    arena->used_before_block = 0;
+    arena_release_large(arena, NULL);
+    arena_save_zero(arena);
+    arena_load_block(arena, arena->first);
+    arena->current = arena->first->start;
+}
+
 void arena_reset(Arena* arena) {
+    arena_reset_blocks(arena);
+    arena_zero_released(arena);
+}
+
+void arena_reset_low(Arena* arena) {
+    arena_track_high_water(arena);
+    arena->generation++;
+    arena_release_large(arena, NULL);
+    arena_track_zero(arena);
     arena->current = arena->start;
 }
 
+void arena_reset_high(Arena* arena) {
+    arena_track_high_water(arena);
+    arena->end = arena->block->end;
+}
+
+// Hands [begin, end) back to the kernel, the mapping stays valid. Returns the bytes released.
+static size_t arena_discard(char* begin, char* end, bool lazy) {
+#ifdef ARENA_HAS_MMAP
+    if (begin >= end) { return 0; }
+#ifdef MADV_FREE
+    int advice = lazy ? MADV_FREE : MADV_DONTNEED;
+#else
+    int advice = MADV_DONTNEED;
+    (void)lazy;
+#endif
+    return madvise(begin, end - begin, advice) == 0 ? (size_t)(end - begin) : 0;
+#else
+    (void)begin;
+    (void)end;
+    (void)lazy;
+    return 0;
+#endif
+}
+
+// Decommits the committed range of a virtual arena beyond `keep` bytes.
+static size_t arena_trim_virtual(Arena* arena, size_t keep, bool lazy) {
+#ifdef ARENA_HAS_MMAP
+    char* base = (char*)arena->first;
+    size_t committed = arena->start - base;
+    committed = keep < arena->size ? committed + keep : committed + arena->size;
+    char* keep_end = base + arena_round_up(committed, arena->commit_granularity);
+    if (keep_end >= arena->end) { return 0; }
+
+    // Dirty pages an earlier lazy trim decommitted lie above `end` and are not discarded again here
+    ArenaBlock* block = arena->block;
+    arena_block_discard_lazily(block, arena->end);
+
+    size_t trimmed = arena_discard(keep_end, arena->end, lazy);
+    if (trimmed == 0 || mprotect(keep_end, trimmed, PROT_NONE) != 0) { return 0; }
+
+    // Pages discarded with MADV_DONTNEED come back zeroed, lazily discarded ones may keep their contents.
+    // A range left above the old `end` is extended down to the new one, the arena has to stop there.
+    if (lazy) {
+        arena_block_discard_lazily(block, keep_end);
+    } else {
+        if (block->zero > keep_end) { block->zero = keep_end; }
+        if (block->discarded) { block->discarded = keep_end; }
+    }
+    arena->size -= trimmed;
+    arena->end = keep_end;
+    block->end = keep_end;
+    return trimmed;
+#else
+    (void)arena;
+    (void)keep;
+    (void)lazy;
+    return 0;
+#endif
+}
+
+// Frees the blocks after the first `keep` bytes of the chain. The tail of a kept mmap-backed
+// block beyond `keep` is handed back to the kernel.
+static size_t arena_trim_blocks(Arena* arena, size_t keep, bool lazy) {
+    size_t kept = 0;
+    size_t trimmed = 0;
+    ArenaBlock* block = arena->first;
+    while (block) {
+        ArenaBlock* next = block->next;
+        size_t block_size = block->end - block->start;
+
+        if (block == arena->first || kept < keep) {
+            if (block->backing != ARENA_BACKING_MALLOC && kept + block_size > keep) {
+                // Keep whole (huge) pages so the remaining part of the block keeps its backing
+                size_t granularity = block->backing == ARENA_BACKING_MMAP ? arena_page_size() : ARENA_HUGE_PAGE_SIZE;
+                size_t offset = arena_round_up(block->start - (char*)block + (keep - kept), granularity);
+                char* discard = (char*)block + offset;
+                if (discard < block->end) {
+                    size_t discarded = arena_discard(discard, block->end, lazy);
+                    trimmed += discarded;
+                    if (discarded > 0 && lazy) { arena_block_discard_lazily(block, discard); }
+                    if (discarded > 0 && !lazy) { arena_block_discard(block, discard); }
+                }
+            }
+            kept += block_size;
+        } else {
+            block->prev->next = next;
+            if (next) { next->prev = block->prev; }
+            arena->size -= block_size;
+            trimmed += block_size;
+            arena_block_free(block);
+        }
+        block = next;
+    }
+    return trimmed;
+}
+
+void arena_reset_trim(Arena* arena, const ArenaRetention* retention) {
+    size_t used = arena_used(arena);
+    arena_reset_blocks(arena);
+
+    size_t keep = SIZE_MAX;
+    switch (retention->kind) {
+        case ARENA_RETAIN_BYTES:
+            keep = retention->bytes;
+            break;
+        case ARENA_RETAIN_HIGH_WATER: {
+            size_t decayed = (size_t)((double)arena->retained * retention->decay);
+            arena->retained = used > decayed ? used : decayed;
+            keep = arena->retained;
+            break;
+        }
+        case ARENA_RETAIN_ALL:
+        default:
+            break;
+    }
+
+    // The single block of a double-ended arena is all there is
+    if (keep != SIZE_MAX && !arena->double_ended) {
+        size_t trimmed = arena->backing == ARENA_BACKING_VIRTUAL ? arena_trim_virtual(arena, keep, retention->lazy)
+                                                                : arena_trim_blocks(arena, keep, retention->lazy);
+        arena_load_block(arena, arena->block);
+#if ARENA_STATS
+        arena->counters.bytes_trimmed += trimmed;
+#else
+        (void)trimmed;
+#endif
+    }
+
+    // Zeroing after the trim skips the memory that was just handed back
+    arena_zero_released(arena);
+}
+
+ArenaMark arena_mark(const Arena* arena) {
+    ArenaMark mark = { arena->block, arena->current, arena->used_before_block, arena->large_objects };
+    return mark;
+}
+
+void arena_rewind(Arena* arena, ArenaMark mark) {
+    arena_zero_wait(arena);
+    arena_track_high_water(arena);
+    arena_release_large(arena, mark.large_objects);
+
+    // Staying in the same block keeps `end`, which is the high side's position in a double-ended arena
+    arena_save_zero(arena);
+    if (mark.block != arena->block) {
+        arena_load_block(arena, mark.block);
+        arena->used_before_block = mark.used_before_block;
+    }
+    arena->current = mark.current;
+}
+
+ArenaTemp arena_temp_begin(Arena* arena) {
+    ArenaTemp temp = { arena, arena_mark(arena) };
+    return temp;
+}
+
+void arena_temp_end(ArenaTemp temp) {
+    arena_rewind(temp.arena, temp.mark);
+}
 
 size_t arena_available(const Arena* arena) {
-    return arena->size - (arena->current - arena->start);
+    // `end` is clamped while background zeroing is in flight or a discarded range lies ahead, the block
+    // is still available. Only a double-ended arena moves it for allocations from the back.
+    size_t available = (arena->double_ended ? arena->end : arena->block->end) - arena->current;
+    for (const ArenaBlock* block = arena->block->next; block; block = block->next) {
+        available += block->end - block->start;
+    }
+    return available;
 }
 
 size_t arena_used(const Arena* arena) {
-    return arena->current - arena->start;
+    // The high side of a double-ended arena is the part of the block past `end`
+    size_t used = arena->used_before_block + (arena->current - arena->start);
+    return arena->double_ended ? used + (arena->block->end - arena->end) : used;
+}
+
+size_t arena_committed(const Arena* arena) {
+    return arena->size;
+}
+
+size_t arena_reserved(const Arena* arena) {
+    return arena->backing == ARENA_BACKING_VIRTUAL ? arena->reserved : arena->size;
 }
 
 float arena_utilization(const Arena* arena) {
-    return (float)arena_used(arena) / arena->size * 100.0f;
+    return (float)arena_used(arena) / (float)arena->size;
+}
+
+static const char* arena_backing_name(ArenaBacking backing) {
+    switch (backing) {
+        case ARENA_BACKING_MALLOC: return "malloc";
+        case ARENA_BACKING_VIRTUAL: return "virtual";
+        case ARENA_BACKING_HUGETLB: return "explicit huge pages";
+        case ARENA_BACKING_TRANSPARENT: return "transparent huge pages";
+        case ARENA_BACKING_MMAP: return "mmap";
+    }
+    return "unknown";
 }
 
 void arena_print_stats(const Arena* arena) {
@@ -90,5 +1046,58 @@ void arena_print_stats(const Arena* arena) {
     printf("  Total size: %zu bytes\n", arena->size);
     printf("  Used: %zu bytes\n", arena_used(arena));
     printf("  Available: %zu bytes\n", arena_available(arena));
-    printf("  Utilization: %.2f%%\n", arena_utilization(arena));
+    printf("  Utilization: %.2f%%\n", arena_utilization(arena) * 100.0f);
+    printf("  Backing:");
+    for (ArenaBacking backing = ARENA_BACKING_MALLOC; backing <= ARENA_BACKING_MMAP; backing++) {
+        size_t blocks = 0;
+        for (const ArenaBlock* block = arena->first; block; block = block->next) {
+            if (block->backing == backing) { blocks++; }
+        }
+        if (blocks > 0) { printf(" %s (%zu %s)", arena_backing_name(backing), blocks, blocks == 1 ? "block" : "blocks"); }
+    }
+    printf("\n");
+    if (arena->backing == ARENA_BACKING_VIRTUAL) {
+        printf("  Committed: %zu bytes\n", arena_committed(arena));
+        printf("  Reserved: %zu bytes\n", arena_reserved(arena));
+    }
+#if ARENA_STATS
+    ArenaStats stats = arena_get_stats(arena);
+    printf("  Allocations: %zu (%zu bytes requested, %zu bytes padding)\n",
+           stats.allocations, stats.bytes_requested, stats.bytes_padding);
+    printf("  High-water mark: %zu bytes\n", stats.high_water);
+    printf("  Growths: %zu (%.3f ms)\n", stats.growths, (double)stats.grow_nanoseconds / 1e6);
+    if (stats.large_objects > 0) {
+        printf("  Large objects: %zu (%zu bytes)\n", stats.large_objects, stats.large_bytes);
+    }
+    if (stats.bytes_trimmed > 0) {
+        printf("  Trimmed: %zu bytes\n", stats.bytes_trimmed);
+    }
+    if (stats.bytes_copied > 0) {
+        printf("  Copied by arena_realloc: %zu bytes\n", stats.bytes_copied);
+    }
+    if (stats.pop_misses > 0) {
+        printf("  Pops not on top: %zu\n", stats.pop_misses);
+    }
+#endif
+}
+
+ArenaStats arena_get_stats(const Arena* arena) {
+    const ArenaCounters* counters = &arena->counters;
+    ArenaStats stats = { 0 };
+    stats.allocations = counters->allocations;
+    stats.bytes_requested = counters->bytes_requested;
+    stats.bytes_padding = counters->bytes_padding;
+    stats.high_water = counters->high_water;
+    stats.growths = counters->growths;
+    stats.bytes_copied = counters->bytes_copied;
+    stats.grow_nanoseconds = counters->grow_nanoseconds;
+    stats.pop_misses = counters->pop_misses;
+    stats.bytes_trimmed = counters->bytes_trimmed;
+    stats.bytes_consumed = stats.bytes_requested + stats.bytes_padding;
+    stats.bytes_in_use = arena_used(arena);
+    stats.capacity = arena->size;
+    stats.large_objects = arena->large_count;
+    stats.large_bytes = arena->large_bytes;
+    if (stats.bytes_in_use > stats.high_water) { stats.high_water = stats.bytes_in_use; }
+    return stats;
 }
@@ -0,0 +1,139 @@
+#include "arena_concurrent.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>  // For memset
+
+// Fetch-add allocations are rounded to this granule so the bump offset always stays aligned to it.
+#define CONCURRENT_ARENA_GRANULE _Alignof(max_align_t)
+
+// Block headers are padded so the usable memory of a block starts at the granule alignment.
+#define CONCURRENT_ARENA_HEADER_SIZE \
+    ((sizeof(ConcurrentArenaBlock) + CONCURRENT_ARENA_GRANULE - 1) & ~(CONCURRENT_ARENA_GRANULE - 1))
+
+static ConcurrentArenaBlock* concurrent_arena_block_new(size_t size) {
+    if (size > SIZE_MAX - CONCURRENT_ARENA_HEADER_SIZE) { return NULL; }
+
+    char* memory = malloc(CONCURRENT_ARENA_HEADER_SIZE + size);
+    if (!memory) { return NULL; }
+
+    ConcurrentArenaBlock* block = (ConcurrentArenaBlock*)memory;
+    block->prev = NULL;
+    atomic_init(&block->offset, 0);
+    block->size = size;
+    block->start = memory + CONCURRENT_ARENA_HEADER_SIZE;
+    return block;
+}
+
+// Tries to carve `size` bytes out of `block`, returns NULL if the block is full.
+static char* concurrent_arena_bump(ConcurrentArenaBlock* block, size_t size, size_t alignment) {
+    if (size > block->size) { return NULL; }
+    size_t rounded = (size + CONCURRENT_ARENA_GRANULE - 1) & ~(CONCURRENT_ARENA_GRANULE - 1);
+
+    if (alignment <= CONCURRENT_ARENA_GRANULE) {
+        // Every offset is a multiple of the granule, so a plain fetch-add hands out aligned memory
+        size_t offset = atomic_fetch_add_explicit(&block->offset, rounded, memory_order_relaxed);
+        if (offset > block->size || size > block->size - offset) { return NULL; }
+        return block->start + offset;
+    }
+
+    size_t offset = atomic_load_explicit(&block->offset, memory_order_relaxed);
+    size_t aligned;
+    do {
+        if (offset > block->size) { return NULL; }
+        aligned = offset + ((size_t)(-(uintptr_t)(block->start + offset)) & (alignment - 1));
+        if (aligned > block->size || size > block->size - aligned) { return NULL; }
+    } while (!atomic_compare_exchange_weak_explicit(&block->offset, &offset, aligned + rounded,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    return block->start + aligned;
+}
+
+// Installs a block large enough for the request after `full`. If another thread installs one
+// first, ours is discarded and the caller retries with the winner.
+static bool concurrent_arena_install_block(ConcurrentArena* arena, ConcurrentArenaBlock* full, size_t size, size_t alignment) {
+    if (size > SIZE_MAX - alignment - CONCURRENT_ARENA_GRANULE) { return false; }
+    size_t needed = size + alignment + CONCURRENT_ARENA_GRANULE;
+
+    size_t block_size = full->size;
+    if (arena->if_size_too_small_double_in_size && block_size <= SIZE_MAX / 2) {
+        block_size *= 2;
+    }
+    if (block_size < needed) { block_size = needed; }
+
+    // Most threads that saw the block run full find the winner's block here, before allocating their own
+    if (atomic_load_explicit(&arena->block, memory_order_acquire) != full) { return true; }
+
+    ConcurrentArenaBlock* block = concurrent_arena_block_new(block_size);
+    if (!block) { return false; }
+    block->prev = full;
+
+    ConcurrentArenaBlock* expected = full;
+    if (!atomic_compare_exchange_strong_explicit(&arena->block, &expected, block,
+                                                 memory_order_acq_rel, memory_order_acquire)) {
+        free(block); // Another thread won the race
+    }
+    return true;
+}
+
+ConcurrentArena* concurrent_arena_new(size_t initial_size, bool if_size_too_small_double_in_size) {
+    ConcurrentArena* arena = malloc(sizeof(ConcurrentArena));
+    if (!arena) { return NULL; }
+
+    ConcurrentArenaBlock* block = concurrent_arena_block_new(initial_size);
+    if (!block) {
+        free(arena);
+        return NULL;
+    }
+
+    atomic_init(&arena->block, block);
+    arena->if_size_too_small_double_in_size = if_size_too_small_double_in_size;
+    return arena;
+}
+
+void* concurrent_arena_allocate(ConcurrentArena* arena, size_t size, size_t alignment) {
+    for (;;) {
+        ConcurrentArenaBlock* block = atomic_load_explicit(&arena->block, memory_order_acquire);
+
+        char* ptr = concurrent_arena_bump(block, size, alignment);
+        if (ptr) {
+            memset(ptr, 0, size); // Initialize allocated memory to zero
+            return ptr;
+        }
+
+        if (!concurrent_arena_install_block(arena, block, size, alignment)) {
+            return NULL; // Growth failed
+        }
+    }
+}
+
+void concurrent_arena_reset(ConcurrentArena* arena) {
+    ConcurrentArenaBlock* block = atomic_load_explicit(&arena->block, memory_order_relaxed);
+
+    ConcurrentArenaBlock* prev = block->prev;
+    while (prev) {
+        ConcurrentArenaBlock* next = prev->prev;
+        free(prev);
+        prev = next;
+    }
+
+    block->prev = NULL;
+    atomic_store_explicit(&block->offset, 0, memory_order_relaxed);
+}
+
+void concurrent_arena_free(ConcurrentArena* arena) {
+    ConcurrentArenaBlock* block = atomic_load_explicit(&arena->block, memory_order_relaxed);
+    while (block) {
+        ConcurrentArenaBlock* prev = block->prev;
+        free(block);
+        block = prev;
+    }
+    free(arena);
+}
+
+size_t concurrent_arena_used(ConcurrentArena* arena) {
+    size_t used = 0;
+    for (ConcurrentArenaBlock* block = atomic_load_explicit(&arena->block, memory_order_acquire); block; block = block->prev) {
+        size_t offset = atomic_load_explicit(&block->offset, memory_order_relaxed);
+        used += offset < block->size ? offset : block->size;
+    }
+    return used;
+}
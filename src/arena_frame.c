@@ -0,0 +1,41 @@
+#include "arena_frame.h"
+#include <stdint.h>
+#include <stdlib.h>
+
+FrameArena* frame_arena_new(size_t frame_count, size_t initial_size, bool if_size_too_small_double_in_size) {
+    if (frame_count == 0 || frame_count > (SIZE_MAX - sizeof(FrameArena)) / sizeof(Arena*)) { return NULL; }
+
+    // The ring of arena pointers lives right after the structure
+    FrameArena* frames = malloc(sizeof(FrameArena) + frame_count * sizeof(Arena*));
+    if (!frames) { return NULL; }
+
+    frames->arenas = (Arena**)(frames + 1);
+    frames->frame_count = frame_count;
+    frames->index = 0;
+    frames->frame = 0;
+    for (size_t i = 0; i < frame_count; i++) {
+        frames->arenas[i] = arena_new(initial_size, if_size_too_small_double_in_size);
+        if (!frames->arenas[i]) {
+            frames->frame_count = i;
+            frame_arena_free(frames);
+            return NULL;
+        }
+    }
+    return frames;
+}
+
+Arena* frame_arena_advance(FrameArena* frames) {
+    frames->index = (frames->index + 1) % frames->frame_count;
+    frames->frame++;
+
+    Arena* arena = frames->arenas[frames->index];
+    arena_reset(arena);
+    return arena;
+}
+
+void frame_arena_free(FrameArena* frames) {
+    for (size_t i = 0; i < frames->frame_count; i++) {
+        arena_free(frames->arenas[i]);
+    }
+    free(frames);
+}
@@ -0,0 +1,71 @@
+#include "arena_pool.h"
+
+// Drops every slot of the pool, used when the arena released the memory they lived in.
+static void arena_pool_restart(ArenaPool* pool) {
+    pool->free_list = NULL;
+    pool->batch_current = NULL;
+    pool->batch_end = NULL;
+    pool->generation = pool->arena->generation;
+    pool->slots_in_use = 0;
+    pool->slots_carved = 0;
+}
+
+void arena_pool_init(ArenaPool* pool, Arena* arena, size_t slot_size, size_t slot_alignment) {
+    // Free slots hold the pointer to the next free slot
+    if (slot_alignment < _Alignof(void*)) { slot_alignment = _Alignof(void*); }
+    if (slot_size < sizeof(void*)) { slot_size = sizeof(void*); }
+    slot_size = (slot_size + slot_alignment - 1) & ~(slot_alignment - 1);
+
+    // Batches are whole pages, but hold at least a few slots
+    size_t batch_size = slot_size * 8;
+    batch_size = (batch_size + ARENA_PAGE_SIZE - 1) & ~(size_t)(ARENA_PAGE_SIZE - 1);
+
+    pool->arena = arena;
+    pool->slot_size = slot_size;
+    pool->slot_alignment = slot_alignment;
+    pool->batch_size = batch_size;
+    arena_pool_restart(pool);
+}
+
+void* arena_pool_alloc(ArenaPool* pool) {
+    if (ARENA_UNLIKELY(pool->generation != pool->arena->generation)) {
+        arena_pool_restart(pool);
+    }
+
+    // Reuse a freed slot
+    void* slot = pool->free_list;
+    if (slot) {
+        pool->free_list = *(void**)slot;
+        pool->slots_in_use++;
+        return slot;
+    }
+
+    // Refill from the arena when the current batch is exhausted
+    if (ARENA_UNLIKELY((size_t)(pool->batch_end - pool->batch_current) < pool->slot_size)) {
+        size_t alignment = pool->slot_alignment > ARENA_CACHE_LINE_SIZE ? pool->slot_alignment : ARENA_CACHE_LINE_SIZE;
+        char* batch = arena_allocate_ex(pool->arena, pool->batch_size, alignment, ARENA_ALLOC_NO_ZERO);
+        if (!batch) { return NULL; }
+        pool->batch_current = batch;
+        pool->batch_end = batch + pool->batch_size;
+    }
+
+    slot = pool->batch_current;
+    pool->batch_current += pool->slot_size;
+    pool->slots_in_use++;
+    pool->slots_carved++;
+    return slot;
+}
+
+void arena_pool_free(ArenaPool* pool, void* ptr) {
+    if (!ptr) { return; }
+
+    // The arena was reset since the pool was last used, the whole pool starts over
+    if (ARENA_UNLIKELY(pool->generation != pool->arena->generation)) {
+        arena_pool_restart(pool);
+        return;
+    }
+
+    *(void**)ptr = pool->free_list;
+    pool->free_list = ptr;
+    pool->slots_in_use--;
+}
@@ -0,0 +1,109 @@
+#include "arena_slab.h"
+#include <stdint.h>
+#include <stdio.h>
+
+// 16 B steps up to 128 B, then four classes per power of two up to ARENA_SLAB_MAX_SIZE.
+static const uint16_t arena_slab_class_sizes[ARENA_SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 80, 96, 112, 128,
+    160, 192, 224, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024,
+    1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096
+};
+
+static size_t arena_slab_class_of(size_t size) {
+    if (size <= 128) { return size == 0 ? 0 : (size - 1) / 16; }
+
+    // Four classes per power of two: (2^power, 2^(power + 1)] is split into steps of 2^(power - 2)
+    size_t power = 7;
+    while (((size_t)1 << (power + 1)) < size) { power++; }
+    size_t step = (size_t)1 << (power - 2);
+    return 8 + (power - 7) * 4 + (size - ((size_t)1 << power) - 1) / step;
+}
+
+// Forgets the statistics of objects that died with the arena's last reset.
+static void arena_slab_sync_generation(ArenaSlab* slab) {
+    if (ARENA_LIKELY(slab->generation == slab->arena->generation)) { return; }
+
+    for (size_t i = 0; i < ARENA_SLAB_CLASS_COUNT; i++) { slab->bytes_requested[i] = 0; }
+    slab->large_allocations = 0;
+    slab->large_bytes = 0;
+    slab->generation = slab->arena->generation;
+}
+
+void arena_slab_init(ArenaSlab* slab, Arena* arena) {
+    slab->arena = arena;
+    for (size_t i = 0; i < ARENA_SLAB_CLASS_COUNT; i++) {
+        arena_pool_init(&slab->classes[i], arena, arena_slab_class_sizes[i], ARENA_SLAB_ALIGNMENT);
+        slab->bytes_requested[i] = 0;
+    }
+    slab->large_allocations = 0;
+    slab->large_bytes = 0;
+    slab->generation = arena->generation;
+}
+
+void* arena_slab_alloc(ArenaSlab* slab, size_t size) {
+    arena_slab_sync_generation(slab);
+
+    if (ARENA_UNLIKELY(size > ARENA_SLAB_MAX_SIZE)) {
+        void* ptr = arena_allocate_ex(slab->arena, size, ARENA_SLAB_ALIGNMENT, ARENA_ALLOC_NO_ZERO);
+        if (ptr) {
+            slab->large_allocations++;
+            slab->large_bytes += size;
+        }
+        return ptr;
+    }
+
+    size_t class_index = arena_slab_class_of(size);
+    void* ptr = arena_pool_alloc(&slab->classes[class_index]);
+    if (ptr) { slab->bytes_requested[class_index] += size; }
+    return ptr;
+}
+
+void arena_slab_free(ArenaSlab* slab, void* ptr, size_t size) {
+    if (!ptr || size > ARENA_SLAB_MAX_SIZE) { return; }
+
+    // After a reset the statistics of the class start over together with its pool
+    size_t class_index = arena_slab_class_of(size);
+    ArenaPool* pool = &slab->classes[class_index];
+    if (slab->generation == slab->arena->generation && pool->generation == slab->arena->generation) {
+        slab->bytes_requested[class_index] -= size;
+    }
+    arena_pool_free(pool, ptr);
+}
+
+ArenaSlabClassStats arena_slab_class_stats(const ArenaSlab* slab, size_t class_index) {
+    const ArenaPool* pool = &slab->classes[class_index];
+    ArenaSlabClassStats stats = { pool->slot_size, 0, 0, 0, 1.0f, 0.0f };
+
+    // Counters from before the arena's last reset describe memory that no longer exists
+    if (slab->generation != slab->arena->generation || pool->generation != slab->arena->generation) {
+        return stats;
+    }
+
+    stats.slots_in_use = pool->slots_in_use;
+    stats.slots_carved = pool->slots_carved;
+    stats.bytes_requested = slab->bytes_requested[class_index];
+    if (stats.slots_carved > 0) {
+        size_t carved_bytes = stats.slots_carved * stats.slot_size;
+        stats.occupancy = (float)stats.slots_in_use / (float)stats.slots_carved;
+        stats.fragmentation = (float)(carved_bytes - stats.bytes_requested) / (float)carved_bytes;
+    }
+    return stats;
+}
+
+void arena_slab_print_stats(const ArenaSlab* slab) {
+    arena_print_stats(slab->arena);
+    printf("Slab Statistics:\n");
+    printf("  %10s %10s %10s %10s %14s\n", "Class", "In use", "Carved", "Occupancy", "Fragmentation");
+    for (size_t i = 0; i < ARENA_SLAB_CLASS_COUNT; i++) {
+        ArenaSlabClassStats stats = arena_slab_class_stats(slab, i);
+        if (stats.slots_carved == 0) { continue; }
+        printf("  %8zu B %10zu %10zu %9.2f%% %13.2f%%\n", stats.slot_size, stats.slots_in_use, stats.slots_carved,
+               stats.occupancy * 100.0f, stats.fragmentation * 100.0f);
+    }
+    if (slab->generation == slab->arena->generation && slab->large_allocations > 0) {
+        printf("  Large: %zu allocations, %zu bytes\n", slab->large_allocations, slab->large_bytes);
+    }
+}
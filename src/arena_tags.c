@@ -0,0 +1,98 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Tags are hashed by content, so equal strings from different translation units share an entry.
+static size_t arena_tag_hash(const char* tag) {
+    uint64_t hash = 14695981039346656037u; // FNV-1a
+    for (const unsigned char* c = (const unsigned char*)tag; *c; c++) {
+        hash = (hash ^ *c) * 1099511628211u;
+    }
+    return (size_t)hash;
+}
+
+// Finds the slot of `tag` in a table of `capacity` slots, or the empty slot where it belongs.
+static ArenaTagStats* arena_tag_slot(ArenaTagStats* tags, size_t capacity, const char* tag) {
+    size_t index = arena_tag_hash(tag) & (capacity - 1);
+    while (tags[index].tag && tags[index].tag != tag && strcmp(tags[index].tag, tag) != 0) {
+        index = (index + 1) & (capacity - 1);
+    }
+    return &tags[index];
+}
+
+// Doubles the table (starting at 16 slots) so it stays at most half full.
+static bool arena_tag_grow(Arena* arena) {
+    size_t capacity = arena->tag_capacity ? arena->tag_capacity * 2 : 16;
+    ArenaTagStats* tags = calloc(capacity, sizeof(ArenaTagStats));
+    if (!tags) { return false; }
+
+    for (size_t i = 0; i < arena->tag_capacity; i++) {
+        if (arena->tags[i].tag) { *arena_tag_slot(tags, capacity, arena->tags[i].tag) = arena->tags[i]; }
+    }
+    free(arena->tags);
+    arena->tags = tags;
+    arena->tag_capacity = capacity;
+    return true;
+}
+
+void arena_tag_record(Arena* arena, const char* tag, size_t size) {
+    if (!tag) { tag = "(untagged)"; }
+    if (arena->tag_count * 2 >= arena->tag_capacity && !arena_tag_grow(arena)) {
+        return; // Accounting is best effort, the allocation itself succeeded
+    }
+
+    ArenaTagStats* entry = arena_tag_slot(arena->tags, arena->tag_capacity, tag);
+    if (!entry->tag) {
+        entry->tag = tag;
+        arena->tag_count++;
+    }
+    entry->allocations++;
+    entry->bytes += size;
+}
+
+static int arena_tag_compare(const void* lhs, const void* rhs) {
+    size_t a = ((const ArenaTagStats*)lhs)->bytes;
+    size_t b = ((const ArenaTagStats*)rhs)->bytes;
+    return (a < b) - (a > b);
+}
+
+// Returns the recorded tags sorted by bytes, the caller frees the array.
+static ArenaTagStats* arena_tag_sorted(const Arena* arena) {
+    ArenaTagStats* sorted = malloc(arena->tag_count * sizeof(ArenaTagStats));
+    if (!sorted) { return NULL; }
+
+    size_t count = 0;
+    for (size_t i = 0; i < arena->tag_capacity; i++) {
+        if (arena->tags[i].tag) { sorted[count++] = arena->tags[i]; }
+    }
+    qsort(sorted, count, sizeof(ArenaTagStats), arena_tag_compare);
+    return sorted;
+}
+
+size_t arena_get_tag_stats(const Arena* arena, ArenaTagStats* out, size_t capacity) {
+    if (arena->tag_count == 0 || capacity == 0) { return arena->tag_count; }
+
+    ArenaTagStats* sorted = arena_tag_sorted(arena);
+    if (!sorted) { return 0; }
+    memcpy(out, sorted, (capacity < arena->tag_count ? capacity : arena->tag_count) * sizeof(ArenaTagStats));
+    free(sorted);
+    return arena->tag_count;
+}
+
+void arena_print_tag_stats(const Arena* arena) {
+    printf("Arena Tag Statistics:\n");
+    if (arena->tag_count == 0) {
+        printf("  %s\n", ARENA_TAGS ? "No tagged allocations" : "Tag accounting disabled (build with ARENA_TAGS=1)");
+        return;
+    }
+
+    ArenaTagStats* sorted = arena_tag_sorted(arena);
+    if (!sorted) { return; }
+    printf("  %14s %12s  %s\n", "Bytes", "Allocations", "Tag");
+    for (size_t i = 0; i < arena->tag_count; i++) {
+        printf("  %14zu %12zu  %s\n", sorted[i].bytes, sorted[i].allocations, sorted[i].tag);
+    }
+    free(sorted);
+}
@@ -0,0 +1,69 @@
+#include "arena.h"
+
+// Same platform detection as arena.c, elsewhere the arenas are not freed at thread exit
+#if defined(__unix__) || defined(__APPLE__)
+#define ARENA_HAS_PTHREADS 1
+#include <pthread.h>
+#endif
+
+static size_t arena_thread_local_initial_size = ARENA_THREAD_LOCAL_DEFAULT_SIZE;
+static bool arena_thread_local_double_in_size = true;
+
+static _Thread_local Arena* arena_thread_local_arena = NULL;
+
+#ifdef ARENA_HAS_PTHREADS
+// The key only exists so the arena is freed when its thread exits, lookups go through the
+// cheaper _Thread_local pointer.
+static pthread_key_t arena_thread_local_key;
+static pthread_once_t arena_thread_local_key_once = PTHREAD_ONCE_INIT;
+static bool arena_thread_local_key_created = false;
+
+static void arena_thread_local_destroy(void* arena) {
+    arena_thread_local_arena = NULL;
+    arena_free(arena);
+}
+
+static void arena_thread_local_create_key(void) {
+    arena_thread_local_key_created = pthread_key_create(&arena_thread_local_key, arena_thread_local_destroy) == 0;
+}
+#endif
+
+void arena_thread_local_configure(size_t initial_size, bool if_size_too_small_double_in_size) {
+    arena_thread_local_initial_size = initial_size;
+    arena_thread_local_double_in_size = if_size_too_small_double_in_size;
+}
+
+Arena* arena_thread_local(void) {
+    Arena* arena = arena_thread_local_arena;
+    if (ARENA_LIKELY(arena)) { return arena; }
+
+#ifdef ARENA_HAS_PTHREADS
+    pthread_once(&arena_thread_local_key_once, arena_thread_local_create_key);
+    if (!arena_thread_local_key_created) { return NULL; }
+#endif
+
+    arena = arena_new(arena_thread_local_initial_size, arena_thread_local_double_in_size);
+    if (!arena) { return NULL; }
+
+#ifdef ARENA_HAS_PTHREADS
+    // Register the arena so the destructor frees it at thread exit
+    if (pthread_setspecific(arena_thread_local_key, arena) != 0) {
+        arena_free(arena);
+        return NULL;
+    }
+#endif
+
+    arena_thread_local_arena = arena;
+    return arena;
+}
+
+void arena_thread_local_free(void) {
+    Arena* arena = arena_thread_local_arena;
+    if (!arena) { return; }
+
+#ifdef ARENA_HAS_PTHREADS
+    pthread_setspecific(arena_thread_local_key, NULL);
+#endif
+    arena_thread_local_arena = NULL;
+    arena_free(arena);
+}